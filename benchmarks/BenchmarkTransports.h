@@ -0,0 +1,99 @@
+#pragma once
+
+#include "IntegralCommunication/BufferedCommunication.h"
+#include "IntegralCommunication/Communication.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+// In-memory transports, so results only depend on the code under test
+
+// Serves the same pre-encoded byte stream every time it is rewound
+class StreamCommunication final : public Communication {
+  public:
+    explicit StreamCommunication(std::vector<uint8_t> stream) : _stream(std::move(stream)) {}
+
+    void rewind() {
+        _position = 0;
+    }
+
+  private:
+    void writeImpl(const uint8_t*, size_t) override {}
+
+    size_t availableImpl() override {
+        return _stream.size() - _position;
+    }
+
+    size_t readImpl(uint8_t* data, size_t size) override {
+        const size_t toRead = std::min(size, _stream.size() - _position);
+        std::memcpy(data, _stream.data() + _position, toRead);
+        _position += toRead;
+        return toRead;
+    }
+
+    std::vector<uint8_t> _stream;
+    size_t _position = 0;
+};
+
+// Accepts every write and only counts the bytes
+class SinkCommunication : public Communication {
+  public:
+    [[nodiscard]] size_t written() const {
+        return _written;
+    }
+
+  private:
+    void writeImpl(const uint8_t*, size_t size) override {
+        _written += size;
+    }
+
+    size_t availableImpl() override {
+        return 0;
+    }
+
+    size_t readImpl(uint8_t*, size_t) override {
+        return 0;
+    }
+
+    size_t _written = 0;
+};
+
+// Takes up to maxPerCall bytes per writeImpl call, like a slow serial port
+class SinkBufferedCommunication : public BufferedCommunication {
+  public:
+    SinkBufferedCommunication(uint8_t* buffer, size_t bufferSize, size_t maxPerCall = SIZE_MAX)
+        : BufferedCommunication(buffer, bufferSize), _maxPerCall(maxPerCall) {}
+
+    [[nodiscard]] size_t written() const {
+        return _written;
+    }
+
+  private:
+    size_t writeImpl(const uint8_t*, size_t dataSize) override {
+        const size_t toWrite = std::min(dataSize, _maxPerCall);
+        _written += toWrite;
+        return toWrite;
+    }
+
+    size_t availableImpl() override {
+        return 0;
+    }
+
+    size_t readImpl(uint8_t*, size_t) override {
+        return 0;
+    }
+
+    size_t _maxPerCall;
+    size_t _written = 0;
+};
+
+// Deterministic payload bytes
+inline std::vector<uint8_t> makePayload(size_t size) {
+    std::vector<uint8_t> payload(size);
+    for (size_t i = 0; i < size; i++) {
+        payload[i] = static_cast<uint8_t>(i * 31);
+    }
+    return payload;
+}
@@ -0,0 +1,144 @@
+#include "BenchmarkTransports.h"
+#include "IntegralCommunication/SevenBitEncoding.h"
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr int64_t MIN_PAYLOAD = 1;
+    constexpr int64_t MAX_PAYLOAD = 1 << 20;
+
+    // Selects a kernel for the lifetime of the benchmark
+    class KernelScope {
+      public:
+        KernelScope(benchmark::State& state, int64_t kernel) : _previous(SevenBitEncoding::activeKernel()) {
+            if (!SevenBitEncoding::selectKernel(static_cast<SevenBitEncoding::Kernel>(kernel))) {
+                state.SkipWithError("kernel not supported on this CPU");
+            }
+        }
+
+        ~KernelScope() {
+            SevenBitEncoding::selectKernel(_previous);
+        }
+
+        KernelScope(const KernelScope&) = delete;
+        KernelScope& operator=(const KernelScope&) = delete;
+
+      private:
+        SevenBitEncoding::Kernel _previous;
+    };
+
+    void BM_EncodeBuffer(benchmark::State& state) {
+        const KernelScope kernel(state, state.range(1));
+        const std::vector<uint8_t> payload = makePayload(static_cast<size_t>(state.range(0)));
+        std::vector<uint8_t> encoded(SevenBitEncoding::getEncodedBufferSize(payload.size()));
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(SevenBitEncoding::encodeBuffer(payload.data(), payload.size(), encoded.data()));
+            benchmark::ClobberMemory();
+        }
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+
+    void BM_DecodeBuffer(benchmark::State& state) {
+        const KernelScope kernel(state, state.range(1));
+        const std::vector<uint8_t> payload = makePayload(static_cast<size_t>(state.range(0)));
+        std::vector<uint8_t> encoded(SevenBitEncoding::getEncodedBufferSize(payload.size()));
+        encoded.resize(SevenBitEncoding::encodeBuffer(payload.data(), payload.size(), encoded.data()));
+        std::vector<uint8_t> decoded(payload.size());
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(
+                SevenBitEncoding::decodeBuffer(encoded.data(), encoded.size(), decoded.data(), decoded.size()));
+            benchmark::ClobberMemory();
+        }
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+
+    // Values of up to maxBits bits spread over every encoded length, so the decode loop cannot learn a fixed
+    // pattern
+    std::vector<uint32_t> mixedValues(size_t count, unsigned maxBits = 32) {
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<unsigned> shiftDist(32 - maxBits, 31);
+        std::vector<uint32_t> values(count);
+        for (auto& value : values) {
+            value = static_cast<uint32_t>(rng()) >> shiftDist(rng);
+        }
+        return values;
+    }
+
+    constexpr size_t VALUE_COUNT = 4096;
+
+    void BM_EncodeValue(benchmark::State& state) {
+        const std::vector<uint32_t> values = mixedValues(VALUE_COUNT);
+        std::vector<uint8_t> encoded(VALUE_COUNT * SevenBitEncoding::MAX_ENCODED_VALUE_SIZE);
+
+        size_t bytes = 0;
+        for (auto _ : state) {
+            size_t position = 0;
+            for (uint32_t value : values) {
+                SevenBitEncoding::encodeValue(value, encoded.data() + position);
+                position += SevenBitEncoding::getEncodedSize(value);
+            }
+            bytes += position;
+            benchmark::ClobberMemory();
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(bytes));
+        state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(VALUE_COUNT));
+    }
+
+    void BM_DecodeValue(benchmark::State& state) {
+        const std::vector<uint32_t> values = mixedValues(VALUE_COUNT);
+        std::vector<uint8_t> encoded(VALUE_COUNT * SevenBitEncoding::MAX_ENCODED_VALUE_SIZE);
+        encoded.resize(SevenBitEncoding::encodeValues(values.data(), values.size(), encoded.data()));
+
+        for (auto _ : state) {
+            size_t position = 0;
+            while (position < encoded.size()) {
+                size_t consumed = 0;
+                benchmark::DoNotOptimize(
+                    SevenBitEncoding::decodeValue(encoded.data() + position, encoded.size() - position, consumed));
+                position += consumed;
+            }
+        }
+        state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(encoded.size()));
+        state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(VALUE_COUNT));
+    }
+
+    void BM_DecodeValues(benchmark::State& state) {
+        const KernelScope kernel(state, state.range(1));
+        const std::vector<uint32_t> values = mixedValues(VALUE_COUNT, static_cast<unsigned>(state.range(0)));
+        std::vector<uint8_t> encoded(VALUE_COUNT * SevenBitEncoding::MAX_ENCODED_VALUE_SIZE);
+        encoded.resize(SevenBitEncoding::encodeValues(values.data(), values.size(), encoded.data()));
+        std::vector<uint32_t> decoded(VALUE_COUNT);
+
+        for (auto _ : state) {
+            size_t consumed = 0;
+            benchmark::DoNotOptimize(SevenBitEncoding::decodeValues(encoded.data(), encoded.size(), decoded.data(),
+                                                                    decoded.size(), consumed));
+            benchmark::ClobberMemory();
+        }
+        state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(encoded.size()));
+        state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(VALUE_COUNT));
+    }
+
+    constexpr std::array<SevenBitEncoding::Kernel, 3> KERNELS = {
+        SevenBitEncoding::Kernel::Scalar, SevenBitEncoding::Kernel::Ssse3, SevenBitEncoding::Kernel::Avx2};
+
+    void payloadsAndKernels(benchmark::internal::Benchmark* benchmark) {
+        benchmark->ArgNames({"bytes", "kernel"});
+        for (int64_t size = MIN_PAYLOAD; size <= MAX_PAYLOAD; size *= 4) {
+            for (SevenBitEncoding::Kernel kernel : KERNELS) {
+                benchmark->Args({size, static_cast<int64_t>(kernel)});
+            }
+        }
+    }
+} // namespace
+
+BENCHMARK(BM_EncodeBuffer)->Apply(payloadsAndKernels);
+BENCHMARK(BM_DecodeBuffer)->Apply(payloadsAndKernels);
+BENCHMARK(BM_EncodeValue);
+BENCHMARK(BM_DecodeValue);
+BENCHMARK(BM_DecodeValues)->ArgNames({"maxBits", "kernel"})->ArgsProduct({{14, 21, 32}, {0, 1, 2}});
@@ -0,0 +1,105 @@
+#include "BenchmarkTransports.h"
+#include "IntegralCommunication/SevenBitEncodedCommunication.h"
+#include "IntegralCommunication/SevenBitEncoding.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace {
+    constexpr int64_t MIN_PAYLOAD = 1;
+    constexpr int64_t MAX_PAYLOAD = 1 << 20;
+    constexpr size_t FRAME_SIZE = SevenBitEncoding::getEncodedBufferSize(MAX_PAYLOAD);
+
+    // Both buffers hold a whole 1 MiB frame, which is too much for the stack
+    using FramedCommunication = SevenBitEncodedCommunication<FRAME_SIZE, FRAME_SIZE>;
+
+    void BM_WriteMessage(benchmark::State& state) {
+        const std::vector<uint8_t> payload = makePayload(static_cast<size_t>(state.range(0)));
+        SinkCommunication sink;
+        const auto comm = std::make_unique<FramedCommunication>(sink);
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(comm->writeMessage(payload.data(), payload.size()));
+        }
+        benchmark::DoNotOptimize(sink.written());
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+
+    // Through the Communication& virtual calls, or with the final transport type as the template argument
+    template <typename Framed, typename Transport> void readMessage(benchmark::State& state) {
+        const std::vector<uint8_t> payload = makePayload(static_cast<size_t>(state.range(0)));
+        std::vector<uint8_t> frame(SevenBitEncoding::getEncodedBufferSize(payload.size()));
+        frame.resize(SevenBitEncoding::encodeBuffer(payload.data(), payload.size(), frame.data()));
+        StreamCommunication stream(frame);
+        const auto comm = std::make_unique<Framed>(static_cast<Transport&>(stream));
+        std::vector<uint8_t> out(payload.size());
+
+        for (auto _ : state) {
+            stream.rewind();
+            size_t outLen = 0;
+            benchmark::DoNotOptimize(comm->readMessage(out.data(), out.size(), outLen));
+        }
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+
+    void BM_ReadMessage(benchmark::State& state) {
+        readMessage<FramedCommunication, Communication>(state);
+    }
+
+    void BM_ReadMessageDirect(benchmark::State& state) {
+        using DirectCommunication = BasicSevenBitEncodedCommunication<StreamCommunication, FRAME_SIZE, FRAME_SIZE>;
+        readMessage<DirectCommunication, StreamCommunication>(state);
+    }
+
+    // Writes a payload through a buffer of 4 KiB and flushes it, as a sender would after each message
+    void BM_BufferedWriteFlush(benchmark::State& state) {
+        const std::vector<uint8_t> payload = makePayload(static_cast<size_t>(state.range(0)));
+        std::vector<uint8_t> buffer(4096);
+        SinkBufferedCommunication comm(buffer.data(), buffer.size());
+
+        for (auto _ : state) {
+            comm.write(payload.data(), payload.size());
+            comm.flush();
+        }
+        benchmark::DoNotOptimize(comm.written());
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+
+    // A full buffer flushed through a transport that takes 64 bytes per call; range(0) selects ring mode
+    void BM_BufferedPartialFlush(benchmark::State& state) {
+        std::vector<uint8_t> buffer(4096);
+        const std::vector<uint8_t> payload = makePayload(buffer.size());
+        SinkBufferedCommunication comm(buffer.data(), buffer.size(), 64);
+        comm.setRingBuffer(state.range(0) != 0);
+
+        for (auto _ : state) {
+            comm.write(payload.data(), payload.size());
+            comm.flush();
+        }
+        benchmark::DoNotOptimize(comm.written());
+        state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(payload.size()));
+    }
+
+    // Payloads larger than the 256-byte buffer, copied through it or written through; range(1) enables write-through
+    void BM_BufferedLargeWrite(benchmark::State& state) {
+        std::vector<uint8_t> buffer(256);
+        const std::vector<uint8_t> payload = makePayload(static_cast<size_t>(state.range(0)));
+        SinkBufferedCommunication comm(buffer.data(), buffer.size());
+        comm.setWriteThrough(state.range(1) != 0);
+
+        for (auto _ : state) {
+            comm.write(payload.data(), payload.size());
+            comm.flush();
+        }
+        benchmark::DoNotOptimize(comm.written());
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+} // namespace
+
+BENCHMARK(BM_WriteMessage)->RangeMultiplier(4)->Range(MIN_PAYLOAD, MAX_PAYLOAD);
+BENCHMARK(BM_ReadMessage)->RangeMultiplier(4)->Range(MIN_PAYLOAD, MAX_PAYLOAD);
+BENCHMARK(BM_ReadMessageDirect)->RangeMultiplier(4)->Range(MIN_PAYLOAD, MAX_PAYLOAD);
+BENCHMARK(BM_BufferedWriteFlush)->RangeMultiplier(4)->Range(MIN_PAYLOAD, MAX_PAYLOAD);
+BENCHMARK(BM_BufferedPartialFlush)->Arg(0)->Arg(1);
+BENCHMARK(BM_BufferedLargeWrite)->ArgsProduct({{1024, 65536}, {0, 1}});
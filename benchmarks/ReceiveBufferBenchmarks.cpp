@@ -0,0 +1,59 @@
+#include "BenchmarkTransports.h"
+#include "IntegralCommunication/CommunicationStats.h"
+#include "IntegralCommunication/SevenBitEncodedCommunication.h"
+#include "IntegralCommunication/SevenBitEncodedRingCommunication.h"
+#include "IntegralCommunication/SevenBitEncoding.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+namespace {
+    constexpr size_t RX_SIZE = 8192;
+
+    // A burst of `frames` back-to-back frames of `payloadSize` bytes each
+    std::vector<uint8_t> encodedBurst(size_t payloadSize, size_t frames) {
+        const std::vector<uint8_t> payload = makePayload(payloadSize);
+        std::vector<uint8_t> frame(SevenBitEncoding::getEncodedBufferSize(payloadSize));
+        frame.resize(SevenBitEncoding::encodeBuffer(payload.data(), payload.size(), frame.data()));
+
+        std::vector<uint8_t> burst;
+        for (size_t i = 0; i < frames; i++) {
+            burst.insert(burst.end(), frame.begin(), frame.end());
+        }
+        return burst;
+    }
+
+    // Comm counts into LocalCounterStats; bytesCompacted() is what the rx buffer moved or copied to decode frames
+    template <typename Comm> void readBurst(benchmark::State& state) {
+        const auto payloadSize = static_cast<size_t>(state.range(0));
+        const auto frames = static_cast<size_t>(state.range(1));
+        StreamCommunication stream(encodedBurst(payloadSize, frames));
+        Comm comm(stream);
+        std::vector<uint8_t> out(payloadSize);
+
+        for (auto _ : state) {
+            stream.rewind();
+            size_t outLen = 0;
+            for (size_t i = 0; i < frames; i++) {
+                comm.readMessage(out.data(), out.size(), outLen);
+            }
+            benchmark::DoNotOptimize(out.data());
+        }
+
+        const auto totalFrames = static_cast<double>(state.iterations() * frames);
+        state.counters["frames/s"] = benchmark::Counter(totalFrames, benchmark::Counter::kIsRate);
+        state.counters["memmoveBytes/frame"] = static_cast<double>(comm.stats().bytesCompacted()) / totalFrames;
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * frames * payloadSize));
+    }
+
+    void BM_LinearReceiveBuffer(benchmark::State& state) {
+        readBurst<SevenBitEncodedCommunication<16, RX_SIZE, LocalCounterStats>>(state);
+    }
+
+    void BM_RingReceiveBuffer(benchmark::State& state) {
+        readBurst<SevenBitEncodedRingCommunication<16, RX_SIZE, LocalCounterStats>>(state);
+    }
+} // namespace
+
+BENCHMARK(BM_LinearReceiveBuffer)->ArgsProduct({{8, 64}, {1, 8, 64}});
+BENCHMARK(BM_RingReceiveBuffer)->ArgsProduct({{8, 64}, {1, 8, 64}});
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "CommunicationStats.h"
+
+// Transmit side for transports that send a whole buffer asynchronously, e.g. a DMA UART or an io_uring sender.
+// buffers holds BufferCount buffers of bufferSize bytes each. The application fills one buffer while the
+// transport sends another: a buffer is handed to startWriteImpl as soon as it is full or flushed, and the
+// transport calls completeWrite() once it went out, from any thread or interrupt. One buffer is in flight at a
+// time and the next queued one is started from completeWrite(), so the link stays busy while data keeps coming.
+//
+// write, flush and the stats belong to one producer thread. The buffers must not be in flight when the object is
+// destroyed.
+template <size_t BufferCount = 2, typename Stats = NoStats> class AsyncBufferedCommunication : private Stats {
+    static_assert(BufferCount >= 2, "use BufferedCommunication for a single buffer");
+
+  public:
+    AsyncBufferedCommunication(uint8_t* buffers, size_t bufferSize) : _buffers(buffers), _bufferSize(bufferSize) {}
+    virtual ~AsyncBufferedCommunication() = default;
+
+    AsyncBufferedCommunication(const AsyncBufferedCommunication&) = delete;
+    AsyncBufferedCommunication& operator=(const AsyncBufferedCommunication&) = delete;
+
+    // Bytes that find every buffer queued or in flight are dropped and counted as tx overflow
+    void write(const uint8_t* data, size_t dataSize) {
+        while (dataSize > 0) {
+            if (_fillLength == 0 && freeBuffers() == 0) {
+                this->onTxOverflow(dataSize);
+                return;
+            }
+
+            const size_t toCopy = std::min(dataSize, _bufferSize - _fillLength);
+            std::memcpy(fillBuffer() + _fillLength, data, toCopy);
+            _fillLength += toCopy;
+            data += toCopy;
+            dataSize -= toCopy;
+
+            if (_fillLength == _bufferSize) {
+                submit();
+            }
+        }
+    }
+
+    // Hands the partly filled buffer to the transport. Does not wait for it to be sent.
+    void flush() {
+        if (_fillLength > 0) {
+            submit();
+        }
+    }
+
+    // Called by the transport when the buffer from the last startWriteImpl has been sent. Starts the next one.
+    void completeWrite() {
+        _completed.fetch_add(1, std::memory_order_release);
+        _writing.store(false);
+        startNext();
+    }
+
+    size_t available() {
+        return availableImpl();
+    }
+
+    size_t read(uint8_t* data, size_t dataSize) {
+        return readImpl(data, dataSize);
+    }
+
+    // Buffers that are neither queued nor in flight, including the one being filled
+    [[nodiscard]] size_t freeBuffers() const noexcept {
+        return BufferCount - (_submitted.load(std::memory_order_relaxed) - _completed.load(std::memory_order_acquire));
+    }
+
+    // Bytes write() can take right now without dropping any
+    [[nodiscard]] size_t freeSpace() const noexcept {
+        return freeBuffers() * _bufferSize - _fillLength;
+    }
+
+    // True once everything written and flushed has been sent
+    [[nodiscard]] bool idle() const noexcept {
+        return _fillLength == 0 && freeBuffers() == BufferCount;
+    }
+
+    [[nodiscard]] const Stats& stats() const noexcept {
+        return *this;
+    }
+
+  private:
+    // Starts sending size bytes at data and returns without waiting; completeWrite() follows once they are sent
+    virtual void startWriteImpl(const uint8_t* data, size_t size) = 0;
+    virtual size_t availableImpl() = 0;
+    virtual size_t readImpl(uint8_t* data, size_t dataSize) = 0;
+
+    uint8_t* fillBuffer() const noexcept {
+        return _buffers + (_submitted.load(std::memory_order_relaxed) % BufferCount) * _bufferSize;
+    }
+
+    void submit() {
+        const size_t submitted = _submitted.load(std::memory_order_relaxed);
+        _lengths[submitted % BufferCount] = _fillLength;
+        this->onBytesWritten(_fillLength);
+        _fillLength = 0;
+        _submitted.store(submitted + 1);
+        startNext();
+    }
+
+    // Producer and completion race to start the next buffer; whoever sets _writing does it. _started is only
+    // touched by the side that holds _writing. Each side stores one flag and then loads the other's, so those
+    // accesses are sequentially consistent: at least one of them sees both stores.
+    void startNext() {
+        for (;;) {
+            bool idle = false;
+            if (!_writing.compare_exchange_strong(idle, true)) {
+                return; // a buffer is in flight, its completion starts the next one
+            }
+
+            const size_t next = _started;
+            if (next == _submitted.load()) {
+                _writing.store(false);
+                if (next != _submitted.load()) {
+                    continue; // submitted after the check, and the producer may have seen _writing still set
+                }
+                return;
+            }
+
+            _started = next + 1; // before the call, which may complete inline
+            startWriteImpl(_buffers + (next % BufferCount) * _bufferSize, _lengths[next % BufferCount]);
+            return;
+        }
+    }
+
+    uint8_t* _buffers;
+    size_t _bufferSize;
+    size_t _fillLength = 0;
+    std::array<size_t, BufferCount> _lengths{};
+    size_t _started = 0;
+    std::atomic<size_t> _submitted{0};
+    std::atomic<size_t> _completed{0};
+    std::atomic<bool> _writing{false};
+};
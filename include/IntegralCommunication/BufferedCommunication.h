@@ -1,23 +1,53 @@
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
-class BufferedCommunication {
+#include "CommunicationStats.h"
+
+// Stats is one of the policies from CommunicationStats.h. The library instantiates NoStats only, so builds without
+// 64-bit atomics never see CounterStats; other policies are instantiated from this header where they are used.
+template <typename Stats> class BasicBufferedCommunication : private Stats {
   public:
-    BufferedCommunication(uint8_t* buffer, size_t bufferSize);
-    virtual ~BufferedCommunication();
+    BasicBufferedCommunication(uint8_t* buffer, size_t bufferSize);
+    // With a read buffer, reads are served from memory that one large readImpl call refills
+    BasicBufferedCommunication(uint8_t* buffer, size_t bufferSize, uint8_t* readBuffer, size_t readBufferSize);
+    virtual ~BasicBufferedCommunication();
 
     void write(const uint8_t* data, size_t dataSize);
     void flush();
+    // The read-ahead bytes, or what availableImpl reports once there are none
     size_t available();
+    // Reads that find the read buffer empty and are at least as large as it go straight to readImpl
     size_t read(uint8_t* data, size_t dataSize);
 
+    // Read-ahead access for framing layers: peek points data at the buffered bytes, refilling first if there are
+    // none, and returns their count. consume drops bytes from the front. fill reads more behind the buffered
+    // bytes, moving them to the front first if needed, and returns how many it added.
+    size_t peek(const uint8_t*& data);
+    void consume(size_t bytes) noexcept;
+    size_t fill();
+
+    // In ring mode the buffer is circular: a partial write only advances the start of the pending bytes instead
+    // of moving them to the front, and a flush writes them in at most two pieces. Only switches while nothing is
+    // pending; returns false otherwise.
+    bool setRingBuffer(bool enabled) noexcept;
+    // With write-through, a write of at least bufferSize bytes flushes the pending ones and hands the data to
+    // writeImpl without copying it. Whatever writeImpl does not take is buffered as usual.
+    void setWriteThrough(bool enabled) noexcept;
+
+    [[nodiscard]] const Stats& stats() const noexcept;
+
   protected:
     [[nodiscard]] uint8_t* buffer() noexcept;
     [[nodiscard]] const uint8_t* buffer() const noexcept;
+    // Number of pending bytes
     [[nodiscard]] size_t bufferIndex() const noexcept;
     [[nodiscard]] size_t bufferSize() const noexcept;
+    // Offset of the first pending byte, always 0 outside ring mode
+    [[nodiscard]] size_t bufferHead() const noexcept;
 
   private:
     // impl hooks
@@ -29,4 +59,193 @@ class BufferedCommunication {
     uint8_t* _buffer;
     size_t _bufferSize;
     size_t _bufferIndex;
+    size_t _bufferHead;
+    bool _ring;
+    bool _writeThrough;
+    uint8_t* _readBuffer;
+    size_t _readBufferSize;
+    size_t _readHead;
+    size_t _readLength;
+};
+
+template <typename Stats>
+BasicBufferedCommunication<Stats>::BasicBufferedCommunication(uint8_t* buffer, size_t bufferSize)
+    : BasicBufferedCommunication(buffer, bufferSize, nullptr, 0) {}
+
+template <typename Stats>
+BasicBufferedCommunication<Stats>::BasicBufferedCommunication(uint8_t* buffer, size_t bufferSize, uint8_t* readBuffer,
+                                                              size_t readBufferSize)
+    : _buffer(buffer), _bufferSize(bufferSize), _bufferIndex(0), _bufferHead(0), _ring(false), _writeThrough(false),
+      _readBuffer(readBuffer), _readBufferSize(readBufferSize), _readHead(0), _readLength(0) {}
+
+template <typename Stats> BasicBufferedCommunication<Stats>::~BasicBufferedCommunication() = default;
+
+template <typename Stats> void BasicBufferedCommunication<Stats>::write(const uint8_t* data, size_t dataSize) {
+    while (_writeThrough && dataSize >= _bufferSize && dataSize > 0) {
+        flush();
+        if (_bufferIndex > 0) {
+            break; // keep the byte order, the rest queues behind the pending bytes
+        }
+
+        const size_t written = writeImpl(data, dataSize);
+        this->onBytesWritten(written);
+        if (written < dataSize) {
+            this->onPartialWrite();
+        }
+        if (written == 0) {
+            break;
+        }
+        data += written;
+        dataSize -= written;
+    }
+
+    while (dataSize > 0) {
+        size_t space = _bufferSize - _bufferIndex;
+
+        if (space == 0) {
+            flush();
+            space = _bufferSize - _bufferIndex;
+            if (space == 0) {
+                // underlying writeImpl can't make space
+                this->onTxOverflow(dataSize);
+                return;
+            }
+        }
+
+        // The free space ends at the end of the buffer or, in ring mode, may wrap around to its front
+        size_t tail = _bufferHead + _bufferIndex;
+        if (tail >= _bufferSize) {
+            tail -= _bufferSize;
+        }
+        const size_t contiguous = std::min(space, _bufferSize - tail);
+
+        const size_t toCopy = (dataSize < contiguous) ? dataSize : contiguous;
+        std::memcpy(_buffer + tail, data, toCopy);
+        _bufferIndex += toCopy;
+        data += toCopy;
+        dataSize -= toCopy;
+    }
+}
+
+template <typename Stats> void BasicBufferedCommunication<Stats>::flush() {
+    while (_bufferIndex > 0) {
+        // Up to the end of the buffer in ring mode, everything otherwise
+        const size_t pending = std::min(_bufferIndex, _bufferSize - _bufferHead);
+        const size_t written = writeImpl(_buffer + _bufferHead, pending);
+        this->onBytesWritten(written);
+        if (written == 0) {
+            // can't push anything out, stop to avoid infinite loop
+            this->onPartialWrite();
+            return;
+        }
+
+        if (written < pending) {
+            this->onPartialWrite();
+            if (!_ring) {
+                std::memmove(_buffer, _buffer + written, _bufferIndex - written);
+            }
+        }
+        _bufferIndex -= written;
+
+        if (_ring) {
+            _bufferHead += written;
+            if (_bufferHead == _bufferSize || _bufferIndex == 0) {
+                _bufferHead = 0; // an empty buffer starts over at the front, so the next flush is one piece
+            }
+        }
+    }
+}
+
+template <typename Stats> size_t BasicBufferedCommunication<Stats>::available() {
+    return _readLength > 0 ? _readLength : availableImpl();
+}
+
+template <typename Stats> size_t BasicBufferedCommunication<Stats>::read(uint8_t* data, size_t dataSize) {
+    if (_readLength == 0) {
+        if (dataSize >= _readBufferSize) {
+            return readImpl(data, dataSize);
+        }
+        fill();
+    }
+
+    const size_t toCopy = std::min(dataSize, _readLength);
+    std::memcpy(data, _readBuffer + _readHead, toCopy);
+    consume(toCopy);
+    return toCopy;
+}
+
+template <typename Stats> size_t BasicBufferedCommunication<Stats>::peek(const uint8_t*& data) {
+    if (_readLength == 0) {
+        fill();
+    }
+    data = _readBuffer + _readHead;
+    return _readLength;
+}
+
+template <typename Stats> void BasicBufferedCommunication<Stats>::consume(size_t bytes) noexcept {
+    bytes = std::min(bytes, _readLength);
+    _readLength -= bytes;
+    _readHead = _readLength == 0 ? 0 : _readHead + bytes;
+}
+
+template <typename Stats> size_t BasicBufferedCommunication<Stats>::fill() {
+    if (_readHead > 0 && _readHead + _readLength == _readBufferSize) {
+        std::memmove(_readBuffer, _readBuffer + _readHead, _readLength);
+        this->onCompact(_readLength);
+        _readHead = 0;
+    }
+
+    const size_t end = _readHead + _readLength;
+    if (end == _readBufferSize) {
+        return 0;
+    }
+    const size_t received = readImpl(_readBuffer + end, _readBufferSize - end);
+    _readLength += received;
+    this->onRxLevel(_readLength);
+    return received;
+}
+
+template <typename Stats> bool BasicBufferedCommunication<Stats>::setRingBuffer(bool enabled) noexcept {
+    if (_bufferIndex > 0) {
+        return false;
+    }
+    _ring = enabled;
+    _bufferHead = 0;
+    return true;
+}
+
+template <typename Stats> void BasicBufferedCommunication<Stats>::setWriteThrough(bool enabled) noexcept {
+    _writeThrough = enabled;
+}
+
+template <typename Stats> const Stats& BasicBufferedCommunication<Stats>::stats() const noexcept {
+    return *this;
+}
+
+template <typename Stats> uint8_t* BasicBufferedCommunication<Stats>::buffer() noexcept {
+    return _buffer;
+}
+
+template <typename Stats> const uint8_t* BasicBufferedCommunication<Stats>::buffer() const noexcept {
+    return _buffer;
+}
+
+template <typename Stats> size_t BasicBufferedCommunication<Stats>::bufferIndex() const noexcept {
+    return _bufferIndex;
+}
+
+template <typename Stats> size_t BasicBufferedCommunication<Stats>::bufferSize() const noexcept {
+    return _bufferSize;
+}
+
+template <typename Stats> size_t BasicBufferedCommunication<Stats>::bufferHead() const noexcept {
+    return _bufferHead;
+}
+
+extern template class BasicBufferedCommunication<NoStats>;
+
+// A class rather than an alias, so `class BufferedCommunication;` still declares it
+class BufferedCommunication : public BasicBufferedCommunication<NoStats> {
+  public:
+    using BasicBufferedCommunication::BasicBufferedCommunication;
 };
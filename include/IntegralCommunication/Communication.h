@@ -8,9 +8,18 @@ class Communication {
     Communication() = default;
     virtual ~Communication() = default;
 
-    void write(const uint8_t* data, size_t size);
-    size_t available();
-    size_t read(uint8_t* data, size_t size);
+    // Inline, so calls through a final subclass need no virtual dispatch
+    void write(const uint8_t* data, size_t size) {
+        writeImpl(data, size);
+    }
+
+    size_t available() {
+        return availableImpl();
+    }
+
+    size_t read(uint8_t* data, size_t size) {
+        return readImpl(data, size);
+    }
 
   private:
     virtual void writeImpl(const uint8_t* data, size_t size) = 0;
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Stats policies for SevenBitEncodedCommunication and BasicBufferedCommunication. The classes derive privately
+// from their policy and call the hooks below; NoStats is empty and its hooks do nothing, so it adds neither
+// size nor code.
+struct NoStats {
+    void onFrameSent(size_t /*payloadBytes*/) {}
+    void onFrameRejected() {} // payload does not fit in the tx buffer
+    void onFrameReceived(size_t /*payloadBytes*/) {}
+    void onFrameDropped() {} // frame decoded to no bytes
+    void onRxLevel(size_t /*bufferedBytes*/) {}
+    void onRxOverflow() {} // rx buffer full without a complete frame
+    void onRxDiscard(size_t /*bytes*/) {} // dropped to resynchronize after an overflow
+    void onScan(size_t /*bytes*/) {}
+    void onCompact(size_t /*movedBytes*/) {}
+    void onBytesWritten(size_t /*bytes*/) {}
+    void onPartialWrite() {} // the transport took less than it was given
+    void onTxOverflow(size_t /*discardedBytes*/) {}
+};
+
+// Counts every hook. Counter is uint64_t for stats read by the same thread, or std::atomic<uint64_t> for
+// stats scraped from another thread.
+template <typename Counter> class BasicCounterStats {
+  public:
+    [[nodiscard]] uint64_t framesSent() const {
+        return get(_framesSent);
+    }
+    [[nodiscard]] uint64_t bytesSent() const {
+        return get(_bytesSent);
+    }
+    [[nodiscard]] uint64_t framesRejected() const {
+        return get(_framesRejected);
+    }
+    [[nodiscard]] uint64_t framesReceived() const {
+        return get(_framesReceived);
+    }
+    [[nodiscard]] uint64_t bytesReceived() const {
+        return get(_bytesReceived);
+    }
+    [[nodiscard]] uint64_t framesDropped() const {
+        return get(_framesDropped);
+    }
+    [[nodiscard]] uint64_t rxHighWater() const {
+        return get(_rxHighWater);
+    }
+    [[nodiscard]] uint64_t rxOverflows() const {
+        return get(_rxOverflows);
+    }
+    [[nodiscard]] uint64_t bytesDiscarded() const {
+        return get(_bytesDiscarded);
+    }
+    [[nodiscard]] uint64_t bytesScanned() const {
+        return get(_bytesScanned);
+    }
+    [[nodiscard]] uint64_t longestScan() const {
+        return get(_longestScan);
+    }
+    [[nodiscard]] uint64_t bytesCompacted() const {
+        return get(_bytesCompacted);
+    }
+    [[nodiscard]] uint64_t bytesWritten() const {
+        return get(_bytesWritten);
+    }
+    [[nodiscard]] uint64_t partialWrites() const {
+        return get(_partialWrites);
+    }
+    [[nodiscard]] uint64_t txOverflowBytes() const {
+        return get(_txOverflowBytes);
+    }
+
+    void onFrameSent(size_t payloadBytes) {
+        add(_framesSent, 1);
+        add(_bytesSent, payloadBytes);
+    }
+    void onFrameRejected() {
+        add(_framesRejected, 1);
+    }
+    void onFrameReceived(size_t payloadBytes) {
+        add(_framesReceived, 1);
+        add(_bytesReceived, payloadBytes);
+    }
+    void onFrameDropped() {
+        add(_framesDropped, 1);
+    }
+    void onRxLevel(size_t bufferedBytes) {
+        raise(_rxHighWater, bufferedBytes);
+    }
+    void onRxOverflow() {
+        add(_rxOverflows, 1);
+    }
+    void onRxDiscard(size_t bytes) {
+        add(_bytesDiscarded, bytes);
+    }
+    void onScan(size_t bytes) {
+        add(_bytesScanned, bytes);
+        raise(_longestScan, bytes);
+    }
+    void onCompact(size_t movedBytes) {
+        add(_bytesCompacted, movedBytes);
+    }
+    void onBytesWritten(size_t bytes) {
+        add(_bytesWritten, bytes);
+    }
+    void onPartialWrite() {
+        add(_partialWrites, 1);
+    }
+    void onTxOverflow(size_t discardedBytes) {
+        add(_txOverflowBytes, discardedBytes);
+    }
+
+  private:
+    // Counters have a single writer, the thread driving the communication, so a relaxed load and store is
+    // enough and avoids a locked read-modify-write.
+    static void add(uint64_t& counter, uint64_t value) {
+        counter += value;
+    }
+
+    static void add(std::atomic<uint64_t>& counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    static void raise(uint64_t& counter, uint64_t value) {
+        if (value > counter) {
+            counter = value;
+        }
+    }
+
+    static void raise(std::atomic<uint64_t>& counter, uint64_t value) {
+        if (value > counter.load(std::memory_order_relaxed)) {
+            counter.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    static uint64_t get(const uint64_t& counter) {
+        return counter;
+    }
+
+    static uint64_t get(const std::atomic<uint64_t>& counter) {
+        return counter.load(std::memory_order_relaxed);
+    }
+
+    Counter _framesSent{};
+    Counter _bytesSent{};
+    Counter _framesRejected{};
+    Counter _framesReceived{};
+    Counter _bytesReceived{};
+    Counter _framesDropped{};
+    Counter _rxHighWater{};
+    Counter _rxOverflows{};
+    Counter _bytesDiscarded{};
+    Counter _bytesScanned{};
+    Counter _longestScan{};
+    Counter _bytesCompacted{};
+    Counter _bytesWritten{};
+    Counter _partialWrites{};
+    Counter _txOverflowBytes{};
+};
+
+using CounterStats = BasicCounterStats<std::atomic<uint64_t>>;
+using LocalCounterStats = BasicCounterStats<uint64_t>;
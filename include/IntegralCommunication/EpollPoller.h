@@ -0,0 +1,35 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/epoll.h>
+
+// Owns an epoll instance. Each descriptor is registered with a context pointer that comes back with its
+// events, e.g. the PosixFdCommunication or link it belongs to.
+class EpollPoller {
+  public:
+    EpollPoller();
+    ~EpollPoller();
+
+    EpollPoller(const EpollPoller&) = delete;
+    EpollPoller& operator=(const EpollPoller&) = delete;
+
+    // False if epoll_create1 failed
+    [[nodiscard]] bool valid() const noexcept;
+
+    // events is a mask of EPOLLIN, EPOLLOUT, EPOLLET, ...
+    bool add(int fd, uint32_t events, void* context);
+    bool modify(int fd, uint32_t events, void* context);
+    bool remove(int fd);
+
+    // Waits up to timeoutMs (-1 for ever) and returns the number of events stored, or -1 on error.
+    // Interrupted waits return 0.
+    int wait(epoll_event* events, int maxEvents, int timeoutMs);
+
+  private:
+    int _fd;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Hands out blocks of blockSize bytes carved from caller-supplied memory of blockSize * blockCount bytes. Free
+// blocks are chained through their first bytes, so the pool needs no memory of its own and blockSize must be at
+// least MIN_BLOCK_SIZE. A pool with smaller blocks is not valid() and hands out nothing. Not thread-safe: share a
+// pool between links served by the same thread.
+class FixedBlockPool {
+  public:
+    static constexpr size_t MIN_BLOCK_SIZE = sizeof(uint8_t*);
+
+    // Told by release() that a block is free again, after it found the pool empty and called wait().
+    // onBlockReleased must not destroy other waiters.
+    class Waiter {
+      public:
+        virtual void onBlockReleased() = 0;
+
+      protected:
+        ~Waiter() = default;
+
+      private:
+        friend class FixedBlockPool;
+
+        Waiter* _nextWaiter = nullptr;
+        bool _waiting = false;
+    };
+
+    FixedBlockPool(uint8_t* memory, size_t blockSize, size_t blockCount);
+
+    FixedBlockPool(const FixedBlockPool&) = delete;
+    FixedBlockPool& operator=(const FixedBlockPool&) = delete;
+
+    // False if blockSize is below MIN_BLOCK_SIZE
+    [[nodiscard]] bool valid() const noexcept;
+
+    // nullptr when every block is taken
+    [[nodiscard]] uint8_t* acquire() noexcept;
+    // block must come from acquire() on this pool. Wakes every waiter; those that lose the race wait again.
+    void release(uint8_t* block);
+
+    // Registers waiter for the next release(), once; a waiter must cancel before it is destroyed
+    void wait(Waiter& waiter) noexcept;
+    void cancelWait(Waiter& waiter) noexcept;
+
+    [[nodiscard]] size_t blockSize() const noexcept;
+    [[nodiscard]] size_t blockCount() const noexcept;
+    [[nodiscard]] size_t freeBlocks() const noexcept;
+    // Lowest number of free blocks seen so far
+    [[nodiscard]] size_t lowWater() const noexcept;
+    // acquire() calls that found the pool empty
+    [[nodiscard]] size_t exhaustions() const noexcept;
+
+  private:
+    uint8_t* _freeList = nullptr;
+    Waiter* _waiters = nullptr;
+    size_t _blockSize;
+    size_t _blockCount;
+    size_t _freeBlocks;
+    size_t _lowWater;
+    size_t _exhaustions = 0;
+};
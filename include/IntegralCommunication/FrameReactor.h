@@ -0,0 +1,198 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "EpollPoller.h"
+#include "PooledSevenBitEncodedCommunication.h"
+#include "PosixFdCommunication.h"
+#include "SevenBitEncodedCommunication.h"
+
+class FrameReactor;
+
+// A framed link served by a FrameReactor. The callbacks run on the thread that calls FrameReactor::runOnce().
+// onFrame and onTxDrained may write to any link but must not destroy their own; onClosed may. Writing to a pipe or
+// socket whose peer is gone raises SIGPIPE, so processes using the reactor usually ignore it.
+class ReactorLink {
+  public:
+    using FrameHandler = std::function<void(const SevenBitMessageView&)>;
+    using EventHandler = std::function<void()>;
+
+    virtual ~ReactorLink();
+
+    ReactorLink(const ReactorLink&) = delete;
+    ReactorLink& operator=(const ReactorLink&) = delete;
+
+    // Called for every complete frame. The view is valid during the call only.
+    void onFrame(FrameHandler handler);
+    // Called once the bytes the kernel could not take right away have been sent
+    void onTxDrained(EventHandler handler);
+    // Called after the peer hung up and the last complete frame was delivered. The link is already removed.
+    void onClosed(EventHandler handler);
+
+    // Returns false if the frame was rejected or dropped for lack of backlog space. A frame the kernel does not
+    // take right away is sent when the descriptor becomes writable, followed by onTxDrained.
+    bool writeMessage(const uint8_t* data, size_t length);
+
+    [[nodiscard]] PosixFdCommunication& transport() noexcept;
+    [[nodiscard]] bool closed() const noexcept;
+
+  protected:
+    explicit ReactorLink(PosixFdCommunication& transport);
+
+    // Stops read events for a link that cannot take the bytes in its descriptor yet, e.g. while it waits for a
+    // buffer; level-triggered readiness would otherwise wake the reactor again right away. Hangups are still
+    // reported.
+    void pauseReading();
+    void resumeReading();
+
+  private:
+    friend class FrameReactor;
+
+    virtual bool encodeMessage(const uint8_t* data, size_t length) = 0;
+    // Decodes the frames of one read from the transport
+    virtual size_t readFrames(const FrameHandler& handler) = 0;
+
+    void handleEvents(uint32_t events);
+    void watchWritable(bool enabled);
+    void close();
+
+    PosixFdCommunication& _transport;
+    FrameReactor* _reactor = nullptr;
+    // Taken at add(): the destructor removes the link after the derived class and its transport are gone
+    int _readFd = -1;
+    int _writeFd = -1;
+    bool _watchingWritable = false;
+    bool _readingPaused = false;
+    bool _closed = false;
+    FrameHandler _frameHandler;
+    EventHandler _txDrainedHandler;
+    EventHandler _closedHandler;
+};
+
+// Serves any number of links from one thread on top of epoll. Nothing spins: runOnce() sleeps in epoll_wait until
+// a link has bytes to read, can take queued bytes or hung up. Links are level-triggered and each readiness event
+// reads at most one rx buffer, so a busy link cannot starve the others.
+class FrameReactor {
+  public:
+    static constexpr int MAX_EVENTS = 64;
+
+    FrameReactor() = default;
+
+    FrameReactor(const FrameReactor&) = delete;
+    FrameReactor& operator=(const FrameReactor&) = delete;
+
+    [[nodiscard]] bool valid() const noexcept;
+
+    // The link must stay alive until it is removed or closed, and links still added go before the reactor
+    bool add(ReactorLink& link);
+    bool remove(ReactorLink& link);
+
+    // Waits up to timeoutMs (-1 for ever) and dispatches what is ready. Returns the number of events handled,
+    // or -1 if epoll_wait failed.
+    int runOnce(int timeoutMs);
+    // Calls runOnce() until stop() is called from a callback or no link is left
+    void run();
+    void stop() noexcept;
+
+    [[nodiscard]] size_t linkCount() const noexcept;
+
+  private:
+    friend class ReactorLink;
+
+    bool watchWritable(ReactorLink& link, bool enabled);
+    bool updateReadEvents(ReactorLink& link);
+    static uint32_t readEvents(const ReactorLink& link) noexcept;
+
+    EpollPoller _poller;
+    epoll_event _events[MAX_EVENTS];
+    int _ready = 0;
+    int _next = 0;
+    size_t _links = 0;
+    bool _stopped = false;
+};
+
+// ReactorLink over a PosixFdCommunication and a SevenBitEncodedCommunication that it owns; the framing calls the
+// final transport directly. Resync on overflow is on, so an oversized frame cannot leave the link readable for
+// ever with no frame to deliver.
+template <size_t TxSize, size_t RxSize, size_t BacklogSize = 4 * TxSize, typename Stats = NoStats>
+class SevenBitEncodedLink final : public ReactorLink {
+  public:
+    using Framing = BasicSevenBitEncodedCommunication<PosixFdCommunication, TxSize, RxSize, Stats>;
+
+    explicit SevenBitEncodedLink(int fd) : SevenBitEncodedLink(fd, fd) {}
+
+    SevenBitEncodedLink(int readFd, int writeFd)
+        : ReactorLink(_fd), _fd(readFd, writeFd, _backlog.data(), _backlog.size()), _comm(_fd) {
+        _comm.setResyncOnOverflow(true);
+    }
+
+    [[nodiscard]] Framing& communication() noexcept {
+        return _comm;
+    }
+
+  private:
+    bool encodeMessage(const uint8_t* data, size_t length) override {
+        return _comm.writeMessage(data, length);
+    }
+
+    size_t readFrames(const FrameHandler& handler) override {
+        return _comm.readMessages(handler);
+    }
+
+    std::array<uint8_t, BacklogSize> _backlog;
+    PosixFdCommunication _fd;
+    Framing _comm;
+};
+
+// ReactorLink over a PooledSevenBitEncodedCommunication, for many mostly idle links: the rx buffer, the tx buffer
+// and the backlog all come from a FixedBlockPool shared by the links of one reactor. A link borrows its rx block
+// while a frame is partly received and gives it back after the frames of a read were delivered, and a write
+// borrows two blocks, one kept as backlog if the kernel does not take the whole frame. A link that finds the pool
+// empty pauses reading until the pool releases a block.
+template <typename Stats = NoStats>
+class PooledSevenBitEncodedLink final : public ReactorLink, private FixedBlockPool::Waiter {
+  public:
+    using Framing = PooledSevenBitEncodedCommunication<Stats, PosixFdCommunication>;
+
+    PooledSevenBitEncodedLink(int fd, FixedBlockPool& pool) : PooledSevenBitEncodedLink(fd, fd, pool) {}
+
+    PooledSevenBitEncodedLink(int readFd, int writeFd, FixedBlockPool& pool)
+        : ReactorLink(_fd), _pool(pool), _fd(readFd, writeFd, pool), _comm(_fd, pool) {}
+
+    ~PooledSevenBitEncodedLink() override {
+        _pool.cancelWait(*this);
+    }
+
+    [[nodiscard]] Framing& communication() noexcept {
+        return _comm;
+    }
+
+  private:
+    bool encodeMessage(const uint8_t* data, size_t length) override {
+        return _comm.writeMessage(data, length);
+    }
+
+    size_t readFrames(const FrameHandler& handler) override {
+        const size_t frames = _comm.readMessages(handler);
+        if (_comm.waitingForRxBlock()) {
+            pauseReading();
+            _pool.wait(*this);
+        }
+        return frames;
+    }
+
+    void onBlockReleased() override {
+        resumeReading();
+    }
+
+    FixedBlockPool& _pool;
+    PosixFdCommunication _fd;
+    Framing _comm;
+};
+
+#endif
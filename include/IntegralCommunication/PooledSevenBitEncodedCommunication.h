@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "Communication.h"
+#include "CommunicationStats.h"
+#include "FixedBlockPool.h"
+#include "SevenBitEncoding.h"
+#include "SevenBitFrameScanner.h"
+
+// SevenBitEncodedCommunication without buffers of its own, for many mostly idle links. The tx buffer is borrowed
+// from a FixedBlockPool for the duration of writeMessage, the rx buffer from the first byte of a frame until the
+// buffered bytes are used up. An idle link holds no block. When the pool is empty, writeMessage fails and reads
+// leave the bytes in the transport for a later call, so nothing is lost. Frames are limited to the block size;
+// longer ones are dropped as with resync on overflow.
+template <typename Stats = NoStats, typename Transport = Communication>
+class PooledSevenBitEncodedCommunication : private Stats {
+  public:
+    PooledSevenBitEncodedCommunication(Transport& inner, FixedBlockPool& pool)
+        : PooledSevenBitEncodedCommunication(inner, pool, pool) {}
+
+    PooledSevenBitEncodedCommunication(Transport& inner, FixedBlockPool& rxPool, FixedBlockPool& txPool)
+        : _inner(inner), _rxPool(rxPool), _txPool(txPool) {}
+
+    ~PooledSevenBitEncodedCommunication() {
+        if (_rxBuffer != nullptr) {
+            _rxPool.release(_rxBuffer);
+        }
+    }
+
+    PooledSevenBitEncodedCommunication(const PooledSevenBitEncodedCommunication&) = delete;
+    PooledSevenBitEncodedCommunication& operator=(const PooledSevenBitEncodedCommunication&) = delete;
+
+    // Returns false if the frame does not fit in a block or no block is free
+    bool writeMessage(const uint8_t* data, size_t length) {
+        uint8_t* block = nullptr;
+        if (SevenBitEncoding::getEncodedBufferSize(length) > _txPool.blockSize() ||
+            (block = _txPool.acquire()) == nullptr) {
+            this->onFrameRejected();
+            return false;
+        }
+
+        const size_t encodedLen = SevenBitEncoding::encodeBuffer(data, length, block);
+        _inner.write(block, encodedLen);
+        _txPool.release(block);
+        this->onFrameSent(length);
+        this->onBytesWritten(encodedLen);
+        return true;
+    }
+
+    bool readMessage(uint8_t* out, size_t maxOutLen, size_t& outLen) {
+        outLen = 0;
+
+        size_t encodedLen = 0;
+        if (!nextFrame(encodedLen)) {
+            return false;
+        }
+
+        const size_t decodedLen = SevenBitEncoding::decodeBuffer(_rxBuffer, encodedLen, out, maxOutLen);
+        _rx.consume(encodedLen);
+        releaseRxBuffer();
+
+        if (decodedLen == 0) {
+            this->onFrameDropped();
+            return false;
+        }
+
+        this->onFrameReceived(decodedLen);
+        outLen = decodedLen;
+        return true;
+    }
+
+    // Decodes the next frame in place. The view stays valid, and the rx block borrowed, until the next read call
+    // or releaseRxBuffer().
+    bool readMessageView(SevenBitMessageView& view) {
+        view = {};
+
+        size_t encodedLen = 0;
+        if (!nextFrame(encodedLen)) {
+            return false;
+        }
+
+        const size_t decodedLen = SevenBitEncoding::decodeBuffer(_rxBuffer, encodedLen, _rxBuffer, encodedLen);
+        _rx.consume(encodedLen);
+
+        if (decodedLen == 0) {
+            this->onFrameDropped();
+            releaseRxBuffer();
+            return false;
+        }
+
+        this->onFrameReceived(decodedLen);
+        view = {_rxBuffer, decodedLen};
+        return true;
+    }
+
+    // Calls handler(const SevenBitMessageView&) for every complete frame after a single read from the transport.
+    // The rx block is given back afterwards unless a partial frame is left in it.
+    template <typename Handler> size_t readMessages(Handler&& handler) {
+        if (!prepareRead()) {
+            return 0;
+        }
+        const size_t frames = _rx.drainFrames(_rxBuffer, _rxPool.blockSize(), true, hooks(), SIZE_MAX, handler);
+        releaseRxBuffer();
+        return frames;
+    }
+
+    // Same as above, but stores up to maxViews views in views. They stay valid, and the rx block borrowed, until
+    // the next read call or releaseRxBuffer().
+    size_t readMessages(SevenBitMessageView* views, size_t maxViews) {
+        if (!prepareRead()) {
+            return 0;
+        }
+        size_t count = 0;
+        return _rx.drainFrames(_rxBuffer, _rxPool.blockSize(), true, hooks(), maxViews,
+                               [&](const SevenBitMessageView& view) { views[count++] = view; });
+    }
+
+    // Drops the frames handed out as views and gives the rx block back if nothing else is left in it. Read calls
+    // do this on their own; call it to return the block early once the views are no longer needed.
+    void releaseRxBuffer() {
+        if (_rxBuffer == nullptr) {
+            return;
+        }
+        _rx.compact(_rxBuffer, hooks());
+        if (_rx.size() == 0) {
+            _rxPool.release(_rxBuffer);
+            _rxBuffer = nullptr;
+        }
+    }
+
+    [[nodiscard]] size_t pendingBytes() const noexcept {
+        return _rx.pendingBytes();
+    }
+
+    // True while the rx block is borrowed
+    [[nodiscard]] bool holdsRxBuffer() const noexcept {
+        return _rxBuffer != nullptr;
+    }
+
+    // True if the last read left bytes in the transport because the pool was empty
+    [[nodiscard]] bool waitingForRxBlock() const noexcept {
+        return _waitingForRxBlock;
+    }
+
+    // Bytes dropped from frames longer than a block
+    [[nodiscard]] size_t discardedBytes() const noexcept {
+        return _rx.discardedBytes();
+    }
+
+    [[nodiscard]] const Stats& stats() const noexcept {
+        return *this;
+    }
+
+  private:
+    Stats& hooks() noexcept {
+        return *this;
+    }
+
+    bool nextFrame(size_t& encodedLen) {
+        if (prepareRead() && _rx.findFrame(_rxBuffer, _rxPool.blockSize(), true, hooks(), encodedLen)) {
+            return true;
+        }
+        releaseRxBuffer(); // resync may have emptied it
+        return false;
+    }
+
+    // Gives back an empty rx block, then borrows one if the transport has bytes and reads them into it
+    bool prepareRead() {
+        releaseRxBuffer();
+
+        const size_t available = _inner.available();
+        if (_rxBuffer == nullptr) {
+            if (available == 0) {
+                return false;
+            }
+            _rxBuffer = _rxPool.acquire();
+            _waitingForRxBlock = _rxBuffer == nullptr;
+            if (_waitingForRxBlock) {
+                return false;
+            }
+        }
+
+        const size_t rxSize = _rxPool.blockSize();
+        if (_rx.size() < rxSize && available != 0) {
+            const size_t toRead = std::min(available, rxSize - _rx.size());
+            _rx.append(_inner.read(_rxBuffer + _rx.size(), toRead), hooks());
+        }
+
+        _rx.skipOverflowedFrame(_rxBuffer, hooks());
+        return true;
+    }
+
+    Transport& _inner;
+    FixedBlockPool& _rxPool;
+    FixedBlockPool& _txPool;
+
+    uint8_t* _rxBuffer = nullptr;
+    SevenBitFrameScanner _rx;
+    bool _waitingForRxBlock = false;
+};
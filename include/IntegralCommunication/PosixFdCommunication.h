@@ -0,0 +1,75 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/uio.h>
+
+#include "Communication.h"
+#include "FixedBlockPool.h"
+
+// Communication over non-blocking file descriptors: pipes, sockets, serial ports and ptys. The descriptors are
+// switched to O_NONBLOCK but not owned; the caller closes them.
+//
+// Communication::write cannot report anything, so bytes the kernel does not take right away (partial writes,
+// EAGAIN) are kept in a caller-supplied backlog and sent first on the next write or flushPending(). The outcome
+// of the last write is available from lastWriteStatus(). Size the backlog for the largest write: while bytes are
+// queued, a write goes in the backlog whole or is dropped whole, but a write larger than the backlog that the
+// kernel only takes part of arrives cut short.
+class PosixFdCommunication final : public Communication {
+  public:
+    enum class WriteStatus : uint8_t {
+        Complete, // everything reached the kernel
+        Queued,   // the rest waits in the backlog; poll for EPOLLOUT and call flushPending()
+        Dropped,  // the backlog had no room for what the kernel did not take, which was discarded
+        Error,    // nothing was sent, see lastError()
+    };
+
+    PosixFdCommunication(int fd, uint8_t* backlog, size_t backlogSize);
+    PosixFdCommunication(int readFd, int writeFd, uint8_t* backlog, size_t backlogSize);
+    // The backlog is a block borrowed from backlogPool for the duration of a write, and kept while it holds bytes
+    PosixFdCommunication(int fd, FixedBlockPool& backlogPool);
+    PosixFdCommunication(int readFd, int writeFd, FixedBlockPool& backlogPool);
+    ~PosixFdCommunication() override;
+
+    PosixFdCommunication(const PosixFdCommunication&) = delete;
+    PosixFdCommunication& operator=(const PosixFdCommunication&) = delete;
+
+    // Writes the buffers with one writev() call behind anything still in the backlog
+    WriteStatus writeVectored(const iovec* buffers, size_t count);
+    // Sends backlogged bytes. Returns true once the backlog is empty.
+    bool flushPending();
+
+    [[nodiscard]] int readFd() const noexcept;
+    [[nodiscard]] int writeFd() const noexcept;
+    [[nodiscard]] size_t pendingTxBytes() const noexcept;
+    [[nodiscard]] size_t droppedTxBytes() const noexcept;
+    [[nodiscard]] WriteStatus lastWriteStatus() const noexcept;
+    // errno of the last failed system call, 0 if none failed
+    [[nodiscard]] int lastError() const noexcept;
+    // Set once read() returned end of file
+    [[nodiscard]] bool closed() const noexcept;
+
+  private:
+    void writeImpl(const uint8_t* data, size_t size) override;
+    size_t availableImpl() override;
+    size_t readImpl(uint8_t* data, size_t size) override;
+
+    WriteStatus queue(const iovec* buffers, size_t count, size_t skip);
+    bool reserveBacklog();
+    void releaseBacklog();
+
+    int _readFd;
+    int _writeFd;
+    uint8_t* _backlog;
+    size_t _backlogSize;
+    FixedBlockPool* _backlogPool = nullptr;
+    size_t _backlogLength = 0;
+    size_t _droppedTxBytes = 0;
+    WriteStatus _lastWriteStatus = WriteStatus::Complete;
+    int _lastError = 0;
+    bool _closed = false;
+};
+
+#endif
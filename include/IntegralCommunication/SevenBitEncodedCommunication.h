@@ -7,90 +7,229 @@
 #include <cstring>
 
 #include "Communication.h"
+#include "CommunicationStats.h"
 #include "SevenBitEncoding.h"
+#include "SevenBitFrameScanner.h"
 
-template <size_t TxSize, size_t RxSize> class SevenBitEncodedCommunication {
+// Stats is one of the policies from CommunicationStats.h; the default NoStats costs nothing.
+// Transport is any type with Communication's write/available/read. With the default, every call goes through the
+// virtual *Impl functions; a final Communication subclass or a plain class lets the compiler inline them.
+template <size_t TxSize, size_t RxSize, typename Stats = NoStats, typename Transport = Communication>
+class SevenBitEncodedCommunication : private Stats {
   public:
-    explicit SevenBitEncodedCommunication(Communication& inner) : _inner(inner) {}
+    explicit SevenBitEncodedCommunication(Transport& inner) : _inner(inner) {}
 
     bool writeMessage(const uint8_t* data, size_t length) {
+        static_assert(TxSize > 0, "without a tx buffer, use writeMessageInPlace");
         const size_t needed = SevenBitEncoding::getEncodedBufferSize(length);
         if (needed > TxSize) {
+            this->onFrameRejected();
             return false; // tx buffer too small
         }
 
-        // Encode into internal TX buffer
-        const size_t encodedLen = SevenBitEncoding::encodeBuffer(data, length, _txBuffer.data());
+        if (needed > TxSize - _txIndex) {
+            flush(); // frames are never split across writes
+        }
+
+        // Encode into internal TX buffer, behind any frames held back by cork()
+        _txIndex += SevenBitEncoding::encodeBuffer(data, length, _txBuffer.data() + _txIndex);
+        this->onFrameSent(length);
 
-        // Write encoded bytes to underlying communication
-        _inner.write(_txBuffer.data(), encodedLen);
+        if (!_corked) {
+            flush();
+        }
         return true;
     }
 
-    bool readMessage(uint8_t* out, size_t maxOutLen, size_t& outLen) {
-        outLen = 0;
+    // Fixed-size messages are encoded with the unrolled codec, and a TxSize that is too small fails to compile.
+    template <size_t N> bool writeMessage(const std::array<uint8_t, N>& message) {
+        static_assert(SevenBitEncoding::getEncodedBufferSize(N) <= TxSize, "TxSize is too small for this message");
+        const std::array<uint8_t, SevenBitEncoding::getEncodedBufferSize(N)> encoded =
+            SevenBitEncoding::encode(message);
+        if (encoded.size() > TxSize - _txIndex) {
+            flush();
+        }
 
-        const size_t available = _inner.available();
-        if (_rxIndex < RxSize && available != 0) {
-            const size_t space = RxSize - _rxIndex;
-            const size_t toRead = std::min(available, space);
-            if (toRead == 0) {
-                return false;
-            }
-
-            const size_t read = _inner.read(_rxBuffer.data() + _rxIndex, toRead);
-            if (read == 0) {
-                return false;
-            }
-
-            _rxIndex += read;
+        std::memcpy(_txBuffer.data() + _txIndex, encoded.data(), encoded.size());
+        _txIndex += encoded.size();
+        this->onFrameSent(N);
+
+        if (!_corked) {
+            flush();
         }
+        return true;
+    }
 
-        if (_rxIndex == 0) {
-            return false;
+    // Encodes the messages back to back and writes them together, splitting only where the tx buffer is full.
+    // Returns how many were sent; stops at the first one that does not fit in the tx buffer.
+    size_t writeMessages(const SevenBitMessageView* messages, size_t count) {
+        const bool corked = _corked;
+        _corked = true;
+
+        size_t sent = 0;
+        while (sent < count && writeMessage(messages[sent].data, messages[sent].size)) {
+            sent++;
         }
 
-        size_t encodedLen = 0;
-        bool found = false;
-
-        for (size_t i = 0; i < _rxIndex; ++i) {
-            if (SevenBitEncoding::isLastByte(_rxBuffer[i])) {
-                encodedLen = i + 1;
-                found = true;
-                break;
-            }
+        _corked = corked;
+        if (!_corked) {
+            flush();
         }
+        return sent;
+    }
+
+    // While corked, writeMessage only packs frames into the tx buffer. They are written in one go when the
+    // buffer is full, on flush() or on uncork().
+    void cork() {
+        _corked = true;
+    }
 
-        if (!found) {
+    void uncork() {
+        _corked = false;
+        flush();
+    }
+
+    void flush() {
+        if (_txIndex > 0) {
+            _inner.write(_txBuffer.data(), _txIndex);
+            this->onBytesWritten(_txIndex);
+            _txIndex = 0;
+        }
+    }
+
+    // Encodes the length payload bytes at the start of buffer in place and writes them, so no tx buffer is
+    // needed. capacity must be at least SevenBitEncoding::getEncodedBufferSize(length).
+    bool writeMessageInPlace(uint8_t* buffer, size_t length, size_t capacity) {
+        if (SevenBitEncoding::getEncodedBufferSize(length) > capacity) {
+            this->onFrameRejected();
+            return false;
+        }
+
+        flush(); // keep corked frames ahead of this one
+
+        const size_t encodedLen = SevenBitEncoding::encodeBufferInPlace(buffer, length);
+        _inner.write(buffer, encodedLen);
+        this->onFrameSent(length);
+        this->onBytesWritten(encodedLen);
+        return true;
+    }
+
+    bool readMessage(uint8_t* out, size_t maxOutLen, size_t& outLen) {
+        outLen = 0;
+
+        size_t encodedLen = 0;
+        if (!nextFrame(encodedLen)) {
             return false;
         }
 
         const size_t decodedLen = SevenBitEncoding::decodeBuffer(_rxBuffer.data(), encodedLen, out, maxOutLen);
+        _rx.consume(encodedLen);
+        _rx.compact(_rxBuffer.data(), hooks());
 
-        if (decodedLen == 0 && encodedLen != 0) {
-            const size_t remaining = _rxIndex - encodedLen;
-            if (remaining > 0) {
-                std::memmove(_rxBuffer.data(), _rxBuffer.data() + encodedLen, remaining);
-            }
-            _rxIndex = remaining;
+        if (decodedLen == 0) {
+            this->onFrameDropped();
             return false;
         }
 
+        this->onFrameReceived(decodedLen);
         outLen = decodedLen;
+        return true;
+    }
+
+    // Decodes the next frame in place inside the rx buffer. The view stays valid until the next read call.
+    bool readMessageView(SevenBitMessageView& view) {
+        view = {};
 
-        const size_t remaining = _rxIndex - encodedLen;
-        if (remaining > 0) {
-            std::memmove(_rxBuffer.data(), _rxBuffer.data() + encodedLen, remaining);
+        size_t encodedLen = 0;
+        if (!nextFrame(encodedLen)) {
+            return false;
         }
-        _rxIndex = remaining;
 
+        const size_t decodedLen =
+            SevenBitEncoding::decodeBuffer(_rxBuffer.data(), encodedLen, _rxBuffer.data(), encodedLen);
+        _rx.consume(encodedLen); // compacted by the next read, after the caller is done with the view
+
+        if (decodedLen == 0) {
+            this->onFrameDropped();
+            return false;
+        }
+
+        this->onFrameReceived(decodedLen);
+        view = {_rxBuffer.data(), decodedLen};
         return true;
     }
 
+    // Decodes every complete frame buffered after a single read from the inner communication and calls
+    // handler(const SevenBitMessageView&) for each. The views stay valid until the next read call.
+    template <typename Handler> size_t readMessages(Handler&& handler) {
+        return drainFrames(SIZE_MAX, handler);
+    }
+
+    // Same as above, but stores up to maxViews views in views.
+    size_t readMessages(SevenBitMessageView* views, size_t maxViews) {
+        size_t count = 0;
+        return drainFrames(maxViews, [&](const SevenBitMessageView& view) { views[count++] = view; });
+    }
+
+    [[nodiscard]] size_t pendingBytes() const noexcept {
+        return _rx.pendingBytes();
+    }
+
+    // Without resync, a frame longer than RxSize fills the rx buffer and blocks every frame behind it. With
+    // resync, the buffered bytes and the rest of that frame up to its terminator are dropped instead.
+    void setResyncOnOverflow(bool enabled) noexcept {
+        _resync = enabled;
+    }
+
+    // Bytes dropped by resync
+    [[nodiscard]] size_t discardedBytes() const noexcept {
+        return _rx.discardedBytes();
+    }
+
+    [[nodiscard]] const Stats& stats() const noexcept {
+        return *this;
+    }
+
   private:
-    Communication& _inner;
+    Stats& hooks() noexcept {
+        return *this;
+    }
+
+    // Reads what the inner communication has and finds the end of the first buffered frame
+    bool nextFrame(size_t& encodedLen) {
+        prepareRead();
+        return _rx.findFrame(_rxBuffer.data(), RxSize, _resync, hooks(), encodedLen);
+    }
+
+    // Drops the frames handed out last, then one available() + read() round trip into the free end of the rx
+    // buffer
+    void prepareRead() {
+        _rx.compact(_rxBuffer.data(), hooks());
+
+        const size_t available = _inner.available();
+        if (_rx.size() < RxSize && available != 0) {
+            const size_t toRead = std::min(available, RxSize - _rx.size());
+            _rx.append(_inner.read(_rxBuffer.data() + _rx.size(), toRead), hooks());
+        }
+
+        _rx.skipOverflowedFrame(_rxBuffer.data(), hooks());
+    }
+
+    template <typename Sink> size_t drainFrames(size_t maxFrames, Sink&& sink) {
+        prepareRead();
+        return _rx.drainFrames(_rxBuffer.data(), RxSize, _resync, hooks(), maxFrames, sink);
+    }
+
+    Transport& _inner;
 
     std::array<uint8_t, TxSize> _txBuffer;
+    size_t _txIndex = 0;
+    bool _corked = false;
     std::array<uint8_t, RxSize> _rxBuffer;
-    size_t _rxIndex = 0;
+    SevenBitFrameScanner _rx;
+    bool _resync = false;
 };
+
+// SevenBitEncodedCommunication bound to a concrete transport type
+template <typename Transport, size_t TxSize, size_t RxSize, typename Stats = NoStats>
+using BasicSevenBitEncodedCommunication = SevenBitEncodedCommunication<TxSize, RxSize, Stats, Transport>;
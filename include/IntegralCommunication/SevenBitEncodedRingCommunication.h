@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "Communication.h"
+#include "CommunicationStats.h"
+#include "SevenBitEncoding.h"
+
+// SevenBitEncodedCommunication with a circular receive buffer. Decoded frames only advance the read position,
+// so frames queued behind each other are never moved; frames that wrap around the end are decoded in place. The
+// only bytes copied are those of the group straddling the end, reported to Stats through onCompact.
+template <size_t TxSize, size_t RxCapacity, typename Stats = NoStats>
+class SevenBitEncodedRingCommunication : private Stats {
+    static_assert(RxCapacity > 0 && (RxCapacity & (RxCapacity - 1)) == 0, "RxCapacity must be a power of two");
+
+  public:
+    explicit SevenBitEncodedRingCommunication(Communication& inner) : _inner(inner) {}
+
+    bool writeMessage(const uint8_t* data, size_t length) {
+        const size_t needed = SevenBitEncoding::getEncodedBufferSize(length);
+        if (needed > TxSize) {
+            this->onFrameRejected();
+            return false; // tx buffer too small
+        }
+
+        const size_t encodedLen = SevenBitEncoding::encodeBuffer(data, length, _txBuffer.data());
+        _inner.write(_txBuffer.data(), encodedLen);
+        this->onFrameSent(length);
+        this->onBytesWritten(encodedLen);
+        return true;
+    }
+
+    bool readMessage(uint8_t* out, size_t maxOutLen, size_t& outLen) {
+        outLen = 0;
+
+        fill();
+
+        if (_tail == _head) {
+            return false;
+        }
+
+        // Positions are free-running counters; only indexing wraps
+        size_t terminator = _tail;
+        while (_scan != _tail) {
+            const size_t start = _scan & MASK;
+            const size_t length = std::min(_tail - _scan, RxCapacity - start);
+            const size_t found = SevenBitEncoding::findLastByte(_rxBuffer.data() + start, length);
+            _scan += found;
+            if (found < length) {
+                terminator = _scan;
+                break;
+            }
+        }
+        if (terminator == _tail) {
+            return false;
+        }
+
+        const size_t start = _head & MASK;
+        const size_t encodedLen = terminator + 1 - _head;
+        const size_t firstLen = std::min(encodedLen, RxCapacity - start);
+
+        size_t decodedLen = 0;
+        if (firstLen == encodedLen) {
+            decodedLen = SevenBitEncoding::decodeBuffer(_rxBuffer.data() + start, encodedLen, out, maxOutLen);
+        } else {
+            decodedLen = decodeWrapped(_rxBuffer.data() + start, firstLen, _rxBuffer.data(), encodedLen - firstLen,
+                                       out, maxOutLen);
+        }
+
+        _head += encodedLen;
+        _scan = _head;
+
+        if (decodedLen == 0) {
+            this->onFrameDropped();
+            return false;
+        }
+        this->onFrameReceived(decodedLen);
+        outLen = decodedLen;
+        return true;
+    }
+
+    [[nodiscard]] size_t pendingBytes() const noexcept {
+        return _tail - _head;
+    }
+
+    [[nodiscard]] const Stats& stats() const noexcept {
+        return *this;
+    }
+
+  private:
+    static constexpr size_t MASK = RxCapacity - 1;
+    static constexpr size_t GROUP = 8; // encoded bytes per 7 decoded bytes
+
+    void fill() {
+        size_t available = _inner.available();
+        // At most two reads: up to the end of the array, then from its start
+        for (int segment = 0; segment < 2 && available != 0; segment++) {
+            const size_t free = RxCapacity - (_tail - _head);
+            const size_t start = _tail & MASK;
+            const size_t toRead = std::min({available, free, RxCapacity - start});
+            if (toRead == 0) {
+                return;
+            }
+
+            const size_t read = _inner.read(_rxBuffer.data() + start, toRead);
+            _tail += read;
+            this->onRxLevel(_tail - _head);
+            if (read < toRead) {
+                return;
+            }
+            available -= read;
+        }
+    }
+
+    // Decodes a frame split at the end of the array. Whole groups are decoded where they are; only the group
+    // straddling the seam is copied out.
+    size_t decodeWrapped(const uint8_t* first, size_t firstLen, const uint8_t* second, size_t secondLen,
+                         uint8_t* out, size_t maxOutLen) {
+        const size_t aligned = firstLen - (firstLen % GROUP);
+        size_t decoded = SevenBitEncoding::decodeBuffer(first, aligned, out, maxOutLen);
+        if (decoded < aligned - (aligned / GROUP)) {
+            return decoded; // out is full
+        }
+
+        const size_t head = firstLen - aligned;
+        if (head == 0) {
+            // The wrap falls between groups, so the rest decodes where it is
+            return decoded + SevenBitEncoding::decodeBuffer(second, secondLen, out + decoded, maxOutLen - decoded);
+        }
+
+        std::array<uint8_t, GROUP> seam{};
+        const size_t tail = std::min(GROUP - head, secondLen);
+        std::memcpy(seam.data(), first + aligned, head);
+        std::memcpy(seam.data() + head, second, tail);
+        this->onCompact(head + tail);
+        decoded += SevenBitEncoding::decodeBuffer(seam.data(), head + tail, out + decoded, maxOutLen - decoded);
+
+        if (tail < secondLen) {
+            decoded +=
+                SevenBitEncoding::decodeBuffer(second + tail, secondLen - tail, out + decoded, maxOutLen - decoded);
+        }
+        return decoded;
+    }
+
+    Communication& _inner;
+
+    std::array<uint8_t, TxSize> _txBuffer;
+    std::array<uint8_t, RxCapacity> _rxBuffer;
+    size_t _head = 0;
+    size_t _tail = 0;
+    size_t _scan = 0;
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "Communication.h"
+#include "SevenBitEncoding.h"
+
+// Sending side of SevenBitEncodedCommunication for many producer threads. submit() claims a slot of a bounded
+// lock-free queue (Vyukov's, with a sequence number per slot), encodes into it and publishes it; producers
+// never wait for each other. A single thread calls drain(), which packs the published frames into writes of up
+// to TxSize bytes in the order their slots were claimed. A frame is never split across writes.
+template <size_t SlotCount, size_t SlotSize, size_t TxSize> class SevenBitEncodedSender {
+    static_assert(SlotCount > 1 && (SlotCount & (SlotCount - 1)) == 0, "SlotCount must be a power of two");
+    static_assert(SlotSize <= TxSize, "every encoded frame has to fit in one write");
+
+  public:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    explicit SevenBitEncodedSender(Communication& inner) : _inner(inner) {
+        for (size_t i = 0; i < SlotCount; i++) {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Thread-safe. Returns false if the encoded frame is larger than SlotSize or every slot is taken.
+    bool submit(const uint8_t* data, size_t length) {
+        if (SevenBitEncoding::getEncodedBufferSize(length) > SlotSize) {
+            return false;
+        }
+
+        size_t position = _enqueuePosition.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        for (;;) {
+            slot = &_slots[position & MASK];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const auto lag = static_cast<std::ptrdiff_t>(sequence - position);
+            if (lag == 0) {
+                if (_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (lag < 0) {
+                return false; // the drainer has not freed this slot yet
+            } else {
+                position = _enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->length = SevenBitEncoding::encodeBuffer(data, length, slot->data.data());
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Single consumer. Writes every frame published so far, stopping at the first claimed slot that is still
+    // being encoded so the order is kept. Returns the number of frames written.
+    size_t drain() {
+        size_t frames = 0;
+        size_t txIndex = 0;
+        for (;;) {
+            Slot& slot = _slots[_dequeuePosition & MASK];
+            if (slot.sequence.load(std::memory_order_acquire) != _dequeuePosition + 1) {
+                break;
+            }
+
+            if (slot.length > TxSize - txIndex) {
+                _inner.write(_txBuffer.data(), txIndex);
+                txIndex = 0;
+            }
+            std::memcpy(_txBuffer.data() + txIndex, slot.data.data(), slot.length);
+            txIndex += slot.length;
+
+            slot.sequence.store(_dequeuePosition + SlotCount, std::memory_order_release);
+            _dequeuePosition++;
+            frames++;
+        }
+
+        if (txIndex > 0) {
+            _inner.write(_txBuffer.data(), txIndex);
+        }
+        return frames;
+    }
+
+  private:
+    static constexpr size_t MASK = SlotCount - 1;
+
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<size_t> sequence{0};
+        size_t length = 0;
+        std::array<uint8_t, SlotSize> data;
+    };
+
+    Communication& _inner;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> _enqueuePosition{0};
+    alignas(CACHE_LINE_SIZE) size_t _dequeuePosition = 0;
+    std::array<Slot, SlotCount> _slots;
+    std::array<uint8_t, TxSize> _txBuffer;
+};
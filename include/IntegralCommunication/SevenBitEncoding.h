@@ -1,20 +1,278 @@
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <utility>
 
 namespace SevenBitEncoding {
-    size_t getEncodedSize(uint32_t value);
+    inline constexpr uint8_t LAST_SEVEN_BITS = 0x7F;
+    inline constexpr uint8_t FIRST_BIT = 0x80;
+    inline constexpr int ENCODING_SIZE = 7;
+
+    // Implementations of the buffer codec, selected from the CPU features at first use.
+    enum class Kernel : uint8_t { Scalar, Ssse3, Avx2 };
+
+    Kernel activeKernel();
+    bool isKernelSupported(Kernel kernel);
+    // Forces a kernel, e.g. for tests and benchmarks. Not safe to call while other threads are encoding.
+    bool selectKernel(Kernel kernel);
+
+    enum class DecodeStatus : uint8_t {
+        Ok,
+        InvalidArgument,
+        InvalidLength,          // no encoder output has this length
+        MissingContinuationBit, // a byte before the last one has its MSB clear
+        MissingTerminator,      // the last byte has its MSB set
+        OutputTooSmall,
+    };
+
+    // One byte per started group of 7 significant bits; zero still takes a byte.
+    constexpr size_t getEncodedSize(uint32_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        const auto bits = static_cast<size_t>(32 - __builtin_clz(value | 1U));
+        return (bits + ENCODING_SIZE - 1) / ENCODING_SIZE;
+#else
+        size_t size = 0;
+        do {
+            size++;
+            value >>= ENCODING_SIZE;
+        } while (value > 0);
+        return size;
+#endif
+    }
+
     void encodeValue(uint32_t value, uint8_t* output);
     uint32_t decodeValue(const uint8_t* input, size_t inputSize, size_t& consumedBytes);
 
-    size_t getEncodedBufferSize(size_t bufferLength);
-    size_t encodeBuffer(const uint8_t* inputBuffer, size_t inputLength, uint8_t* outputBuffer);
-    size_t decodeBuffer(const uint8_t* inputBuffer, size_t inputLength, uint8_t* outputBuffer, size_t outputLength);
+    inline constexpr size_t MAX_ENCODED_VALUE_SIZE = 5;
+    inline constexpr size_t MAX_ENCODED_VALUE64_SIZE = 10;
+
+    constexpr size_t getEncodedSize64(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        const auto bits = static_cast<size_t>(64 - __builtin_clzll(value | 1ULL));
+        return (bits + ENCODING_SIZE - 1) / ENCODING_SIZE;
+#else
+        size_t size = 0;
+        do {
+            size++;
+            value >>= ENCODING_SIZE;
+        } while (value > 0);
+        return size;
+#endif
+    }
+
+    void encodeValue64(uint64_t value, uint8_t* output);
+    uint64_t decodeValue64(const uint8_t* input, size_t inputSize, size_t& consumedBytes);
+
+    // Maps signed values to unsigned ones with small magnitudes first: 0, -1, 1, -2, ... -> 0, 1, 2, 3, ...
+    constexpr uint32_t zigZagEncode(const int32_t value) {
+        return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    }
+
+    constexpr int32_t zigZagDecode(const uint32_t value) {
+        return static_cast<int32_t>((value >> 1) ^ (0U - (value & 1U)));
+    }
+
+    constexpr uint64_t zigZagEncode64(const int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    constexpr int64_t zigZagDecode64(const uint64_t value) {
+        return static_cast<int64_t>((value >> 1) ^ (0ULL - (value & 1ULL)));
+    }
 
-    bool isLastByte(uint8_t byte);
+    // Bulk variants of encodeValue/encodeValue64, producing the same bytes back to back. output must hold
+    // count * MAX_ENCODED_VALUE_SIZE (MAX_ENCODED_VALUE64_SIZE) bytes. Returns the number of bytes written.
+    size_t encodeValues(const uint32_t* values, size_t count, uint8_t* output);
+    size_t encodeValues(const uint64_t* values, size_t count, uint8_t* output);
+    size_t encodeSignedValues(const int32_t* values, size_t count, uint8_t* output);
+    size_t encodeSignedValues(const int64_t* values, size_t count, uint8_t* output);
 
-    inline uint8_t leftMask(uint8_t n) {
+    // Decodes up to count values, each as decodeValue/decodeValue64 would. Stops before a value cut off by the
+    // end of input, so consumedBytes can be used to resume once more input has arrived. Returns the number of
+    // values decoded.
+    size_t decodeValues(const uint8_t* input, size_t inputSize, uint32_t* values, size_t count,
+                        size_t& consumedBytes);
+    size_t decodeValues(const uint8_t* input, size_t inputSize, uint64_t* values, size_t count,
+                        size_t& consumedBytes);
+    size_t decodeSignedValues(const uint8_t* input, size_t inputSize, int32_t* values, size_t count,
+                              size_t& consumedBytes);
+    size_t decodeSignedValues(const uint8_t* input, size_t inputSize, int64_t* values, size_t count,
+                              size_t& consumedBytes);
+
+    constexpr size_t getEncodedBufferSize(const size_t bufferLength) {
+        return (bufferLength > 0) ? bufferLength + ((bufferLength - 1) / ENCODING_SIZE) + 1 : 1;
+    }
+
+    // Encodes the inputLength bytes at the start of buffer over themselves, working backward from the end.
+    // buffer must hold getEncodedBufferSize(inputLength) bytes.
+    size_t encodeBufferInPlace(uint8_t* buffer, size_t inputLength);
+    // Decodes inputBuffer only if it is exactly one encoded message. decodedLength stays 0 on error.
+    DecodeStatus decodeBuffer(const uint8_t* inputBuffer, size_t inputLength, uint8_t* outputBuffer,
+                              size_t outputLength, size_t& decodedLength);
+
+    constexpr bool isLastByte(const uint8_t byte) {
+        return (byte & FIRST_BIT) == 0;
+    }
+
+    // Index of the first byte with the MSB clear, or length if the buffer holds no complete message
+    size_t findLastByte(const uint8_t* buffer, size_t length);
+
+    constexpr uint8_t leftMask(uint8_t n) {
         return static_cast<uint8_t>((1 << (n)) - 1);
     }
+
+    namespace detail {
+        // Scalar codec loops, starting on a group boundary. encodeSeptets sets the MSB of every byte it writes,
+        // including the last one.
+        constexpr size_t encodeSeptets(const uint8_t* input, const size_t length, uint8_t* output) {
+            size_t outIndex = 0;
+            uint8_t carry = 0;
+            int carryBits = 0;
+            for (size_t i = 0; i < length; i++) {
+                const uint8_t current = input[i];
+                output[outIndex++] = static_cast<uint8_t>(carry | (current >> (carryBits + 1)) | FIRST_BIT);
+                carryBits++;
+                carry = static_cast<uint8_t>((current & leftMask(static_cast<uint8_t>(carryBits)))
+                                             << (ENCODING_SIZE - carryBits));
+                if (carryBits == ENCODING_SIZE) {
+                    output[outIndex++] = carry | FIRST_BIT;
+                    carry = 0;
+                    carryBits = 0;
+                }
+            }
+            if (carryBits != 0) {
+                output[outIndex++] = carry | FIRST_BIT;
+            }
+            return outIndex;
+        }
+
+        constexpr size_t decodeSeptets(const uint8_t* input, const size_t inputLength, uint8_t* output,
+                                       const size_t outputLength) {
+            size_t decoded = 0;
+            size_t encodedIndex = 0;
+            int bitShiftIndex = 0;
+            while (decoded < outputLength && encodedIndex + 1 < inputLength) {
+                const uint8_t currentByte = input[encodedIndex] & LAST_SEVEN_BITS;
+                const uint8_t nextByte = input[encodedIndex + 1] & LAST_SEVEN_BITS;
+                const int bits = bitShiftIndex + 1;
+                const auto carry = static_cast<uint8_t>((nextByte >> (ENCODING_SIZE - bits)) & ((1 << bits) - 1));
+                const auto upperPart = static_cast<uint8_t>(currentByte & ((1 << (ENCODING_SIZE - bitShiftIndex)) - 1));
+                output[decoded++] = static_cast<uint8_t>((upperPart << bits) | carry);
+                bitShiftIndex++;
+                encodedIndex++;
+                if (bitShiftIndex == ENCODING_SIZE) {
+                    encodedIndex++;
+                    bitShiftIndex = 0;
+                }
+            }
+            return decoded;
+        }
+
+        // Runtime codec with the SIMD and word-at-a-time kernels, in src/SevenBitEncoding.cpp
+        size_t encodeBufferKernels(const uint8_t* inputBuffer, size_t inputLength, uint8_t* outputBuffer);
+        size_t decodeBufferKernels(const uint8_t* inputBuffer, size_t inputLength, uint8_t* outputBuffer,
+                                   size_t outputLength);
+    } // namespace detail
+
+#if defined(__clang__)
+#define INTEGRALCOMM_CONSTEXPR_CODEC (__clang_major__ >= 9)
+#elif defined(__GNUC__)
+#define INTEGRALCOMM_CONSTEXPR_CODEC (__GNUC__ >= 9)
+#elif defined(_MSC_VER)
+#define INTEGRALCOMM_CONSTEXPR_CODEC (_MSC_VER >= 1928)
+#else
+#define INTEGRALCOMM_CONSTEXPR_CODEC 0
+#endif
+
+    // With INTEGRALCOMM_CONSTEXPR_CODEC, encodeBuffer and decodeBuffer also work in constant expressions, where
+    // they run the scalar loops above; at run time they use the fastest kernel the CPU supports.
+#if INTEGRALCOMM_CONSTEXPR_CODEC
+    constexpr size_t encodeBuffer(const uint8_t* inputBuffer, const size_t inputLength, uint8_t* outputBuffer) {
+        if (inputLength == 0) {
+            return 0;
+        }
+        if (__builtin_is_constant_evaluated()) {
+            const size_t encodedLength = detail::encodeSeptets(inputBuffer, inputLength, outputBuffer);
+            outputBuffer[encodedLength - 1] &= LAST_SEVEN_BITS;
+            return encodedLength;
+        }
+        return detail::encodeBufferKernels(inputBuffer, inputLength, outputBuffer);
+    }
+
+    // outputBuffer may equal inputBuffer: output never overtakes the input still to be read.
+    constexpr size_t decodeBuffer(const uint8_t* inputBuffer, const size_t inputLength, uint8_t* outputBuffer,
+                                  const size_t outputLength) {
+        if (inputBuffer == nullptr || outputLength == 0) {
+            return 0;
+        }
+        if (__builtin_is_constant_evaluated()) {
+            return detail::decodeSeptets(inputBuffer, inputLength, outputBuffer, outputLength);
+        }
+        return detail::decodeBufferKernels(inputBuffer, inputLength, outputBuffer, outputLength);
+    }
+#else
+    inline size_t encodeBuffer(const uint8_t* inputBuffer, const size_t inputLength, uint8_t* outputBuffer) {
+        return inputLength == 0 ? 0 : detail::encodeBufferKernels(inputBuffer, inputLength, outputBuffer);
+    }
+
+    // outputBuffer may equal inputBuffer: output never overtakes the input still to be read.
+    inline size_t decodeBuffer(const uint8_t* inputBuffer, const size_t inputLength, uint8_t* outputBuffer,
+                               const size_t outputLength) {
+        if (inputBuffer == nullptr || outputLength == 0) {
+            return 0;
+        }
+        return detail::decodeBufferKernels(inputBuffer, inputLength, outputBuffer, outputLength);
+    }
+#endif
+
+    namespace detail {
+        // Septet j of the big-endian bit stream formed by input, zero-padded past its end
+        template <size_t N> constexpr uint8_t septetAt(const std::array<uint8_t, N>& input, const size_t j) {
+            const size_t bit = j * ENCODING_SIZE;
+            const size_t byte = bit / 8;
+            const size_t offset = bit % 8;
+            const unsigned next = (offset > 1 && byte + 1 < N) ? input[byte + 1] : 0U;
+            const unsigned window = (static_cast<unsigned>(input[byte]) << 8) | next;
+            return static_cast<uint8_t>((window >> (9 - offset)) & LAST_SEVEN_BITS);
+        }
+
+        // Byte k of the bit stream formed by the septets of input
+        template <size_t L> constexpr uint8_t byteAt(const std::array<uint8_t, L>& input, const size_t k) {
+            const size_t bit = k * 8;
+            const size_t septet = bit / ENCODING_SIZE;
+            const size_t offset = bit % ENCODING_SIZE;
+            const unsigned window = (static_cast<unsigned>(input[septet] & LAST_SEVEN_BITS) << ENCODING_SIZE) |
+                                    (input[septet + 1] & LAST_SEVEN_BITS);
+            return static_cast<uint8_t>(window >> (ENCODING_SIZE - 1 - offset));
+        }
+
+        template <size_t N, size_t... J>
+        constexpr std::array<uint8_t, sizeof...(J)> encodeUnrolled(const std::array<uint8_t, N>& input,
+                                                                   std::index_sequence<J...> /*septets*/) {
+            return {{static_cast<uint8_t>(septetAt(input, J) | ((J + 1 < sizeof...(J)) ? FIRST_BIT : 0))...}};
+        }
+
+        template <size_t L, size_t... K>
+        constexpr std::array<uint8_t, sizeof...(K)> decodeUnrolled(const std::array<uint8_t, L>& input,
+                                                                   std::index_sequence<K...> /*bytes*/) {
+            return {{byteAt(input, K)...}};
+        }
+    } // namespace detail
+
+    // Compile-time sized codec for fixed-size messages. Every output byte is a separate expression with constant
+    // shifts, so there is no loop left once the call is inlined.
+    template <size_t N>
+    constexpr std::array<uint8_t, getEncodedBufferSize(N)> encode(const std::array<uint8_t, N>& input) {
+        static_assert(N > 0, "an empty message encodes to no bytes");
+        return detail::encodeUnrolled(input, std::make_index_sequence<getEncodedBufferSize(N)>{});
+    }
+
+    // Inverse of encode<N>; N has to be given explicitly.
+    template <size_t N>
+    constexpr std::array<uint8_t, N> decode(const std::array<uint8_t, getEncodedBufferSize(N)>& input) {
+        static_assert(N > 0, "an empty message encodes to no bytes");
+        return detail::decodeUnrolled(input, std::make_index_sequence<N>{});
+    }
 } // namespace SevenBitEncoding
\ No newline at end of file
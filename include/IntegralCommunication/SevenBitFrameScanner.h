@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "SevenBitEncoding.h"
+
+// A decoded message that lives in a buffer owned by someone else
+struct SevenBitMessageView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+// Rx side of SevenBitEncodedCommunication and PooledSevenBitEncodedCommunication: tracks the bytes read into an rx
+// buffer and finds, decodes and drops the frames in it. The buffer is passed to every call, so the owner decides
+// where it lives, and so are the owner's Stats hooks.
+//
+// Bytes [0, consumed()) belong to frames already handed out, [consumed(), size()) wait for a terminator.
+class SevenBitFrameScanner {
+  public:
+    [[nodiscard]] size_t size() const noexcept {
+        return _rxIndex;
+    }
+
+    [[nodiscard]] size_t consumed() const noexcept {
+        return _consumed;
+    }
+
+    [[nodiscard]] size_t pendingBytes() const noexcept {
+        return _rxIndex - _consumed;
+    }
+
+    [[nodiscard]] size_t discardedBytes() const noexcept {
+        return _discardedBytes;
+    }
+
+    // Takes note of bytes the owner read into the buffer behind size()
+    template <typename Stats> void append(size_t bytes, Stats& stats) {
+        _rxIndex += bytes;
+        stats.onRxLevel(_rxIndex);
+    }
+
+    // Marks the frame ending at end as handed out; compact() drops it
+    void consume(size_t end) noexcept {
+        _consumed = end;
+    }
+
+    // Finds the end of the frame starting at consumed(). Bytes before _scanIndex were checked by earlier calls, so
+    // each byte is only scanned once. With resync, a full buffer without a terminator is dropped along with the
+    // rest of its frame. Without it the buffer stays full, and the overflow is reported once until bytes are
+    // dropped.
+    template <typename Stats>
+    bool findFrame(uint8_t* buffer, size_t capacity, bool resync, Stats& stats, size_t& end) {
+        const size_t terminator =
+            _scanIndex + SevenBitEncoding::findLastByte(buffer + _scanIndex, _rxIndex - _scanIndex);
+        if (terminator == _rxIndex) {
+            stats.onScan(_rxIndex - _scanIndex);
+            _scanIndex = _rxIndex;
+            if (_consumed == 0 && _rxIndex == capacity) {
+                if (!_overflowed) {
+                    _overflowed = true;
+                    stats.onRxOverflow(); // no frame can complete until bytes are dropped
+                }
+                if (resync) {
+                    _skipping = true;
+                    discard(_rxIndex, stats);
+                    compact(buffer, stats);
+                }
+            }
+            return false;
+        }
+        stats.onScan(terminator + 1 - _scanIndex);
+        end = terminator + 1;
+        _scanIndex = end;
+        return true;
+    }
+
+    // After an overflow in resync mode, drops bytes up to and including the terminator of the frame that did not
+    // fit, so the next frame starts at the front of the buffer again
+    template <typename Stats> void skipOverflowedFrame(uint8_t* buffer, Stats& stats) {
+        if (!_skipping) {
+            return;
+        }
+        const size_t terminator = SevenBitEncoding::findLastByte(buffer, _rxIndex);
+        _skipping = terminator == _rxIndex;
+        discard(_skipping ? _rxIndex : terminator + 1, stats);
+        compact(buffer, stats);
+    }
+
+    // Decodes every complete frame in place and hands the non-empty ones to sink, up to maxFrames
+    template <typename Stats, typename Sink>
+    size_t drainFrames(uint8_t* buffer, size_t capacity, bool resync, Stats& stats, size_t maxFrames, Sink&& sink) {
+        size_t frames = 0;
+        size_t end = 0;
+        while (frames < maxFrames && findFrame(buffer, capacity, resync, stats, end)) {
+            uint8_t* frame = buffer + _consumed;
+            const size_t decodedLen = SevenBitEncoding::decodeBuffer(frame, end - _consumed, frame, end - _consumed);
+            _consumed = end;
+            if (decodedLen == 0) {
+                stats.onFrameDropped();
+                continue;
+            }
+            stats.onFrameReceived(decodedLen);
+            sink(SevenBitMessageView{frame, decodedLen});
+            frames++;
+        }
+        return frames;
+    }
+
+    // Drops the frames handed out so far
+    template <typename Stats> void compact(uint8_t* buffer, Stats& stats) {
+        if (_consumed == 0) {
+            return;
+        }
+        const size_t remaining = _rxIndex - _consumed;
+        if (remaining > 0) {
+            std::memmove(buffer, buffer + _consumed, remaining);
+            stats.onCompact(remaining);
+        }
+        _rxIndex = remaining;
+        _scanIndex -= _consumed;
+        _consumed = 0;
+        _overflowed = false;
+    }
+
+  private:
+    template <typename Stats> void discard(size_t bytes, Stats& stats) {
+        _consumed = bytes;
+        _scanIndex = std::max(_scanIndex, bytes);
+        _discardedBytes += bytes;
+        stats.onRxDiscard(bytes);
+    }
+
+    size_t _rxIndex = 0;
+    size_t _scanIndex = 0;
+    size_t _consumed = 0;
+    bool _skipping = false;
+    bool _overflowed = false;
+    size_t _discardedBytes = 0;
+};
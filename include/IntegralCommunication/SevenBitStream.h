@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Encodes a message handed over in arbitrary chunks. The concatenated output of encode() and finish() is
+// identical to SevenBitEncoding::encodeBuffer over the whole message.
+class SevenBitEncoder {
+  public:
+    // Most bytes finish() writes
+    static constexpr size_t MAX_FINISH_SIZE = 2;
+
+    // Most bytes a single encode() call writes for inputLength input bytes
+    static size_t getEncodedChunkSize(size_t inputLength);
+
+    size_t encode(const uint8_t* input, size_t inputLength, uint8_t* output);
+    // Writes the remaining bytes, the last one without continuation bit, and starts a new message
+    size_t finish(uint8_t* output);
+    void reset();
+
+  private:
+    void emit(uint8_t septet, uint8_t* output, size_t& outIndex);
+
+    // The newest septet is held back until it is known whether it ends the message
+    uint8_t _pending = 0;
+    bool _hasPending = false;
+    uint8_t _carry = 0;
+    int _carryBits = 0;
+};
+
+// Decodes a stream of encoded messages fed in arbitrary chunks.
+class SevenBitDecoder {
+  public:
+    enum class Status : uint8_t {
+        NeedInput,     // all input consumed, the message continues
+        FrameComplete, // consumed up to and including the last byte of a message
+        OutputFull,    // stopped before an input byte that would produce output
+    };
+
+    Status decode(const uint8_t* input, size_t inputLength, size_t& consumed, uint8_t* output, size_t outputLength,
+                  size_t& produced);
+    void reset();
+
+  private:
+    uint16_t _bits = 0;
+    int _bitCount = 0;
+};
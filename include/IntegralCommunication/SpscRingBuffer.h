@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Lock-free byte queue between one producer and one consumer, e.g. an ISR and a worker thread. The positions
+// are free-running counters on separate cache lines; each side publishes its own with a release store and
+// reads the other's with an acquire load. The cached copies save that load while the last value seen still
+// covers the whole contiguous region.
+template <size_t Capacity> class SpscRingBuffer {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+  public:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    // ----- producer -----
+
+    // Copies as much of data as fits and returns how many bytes that was
+    size_t write(const uint8_t* data, size_t size) {
+        size_t written = 0;
+        // At most two regions: up to the end of the array, then from its start
+        for (int segment = 0; segment < 2 && written < size; segment++) {
+            size_t region = 0;
+            uint8_t* out = prepareWrite(region);
+            const size_t toCopy = std::min(region, size - written);
+            if (toCopy == 0) {
+                break;
+            }
+            std::memcpy(out, data + written, toCopy);
+            commitWrite(toCopy);
+            written += toCopy;
+        }
+        return written;
+    }
+
+    // Contiguous free space at the write position, for DMA or a direct memcpy. Publish with commitWrite().
+    uint8_t* prepareWrite(size_t& size) {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        const size_t start = tail & MASK;
+        if (Capacity - (tail - _cachedHead) < Capacity - start) {
+            _cachedHead = _head.load(std::memory_order_acquire);
+        }
+        size = std::min(Capacity - (tail - _cachedHead), Capacity - start);
+        return _buffer.data() + start;
+    }
+
+    void commitWrite(size_t bytes) {
+        _tail.store(_tail.load(std::memory_order_relaxed) + bytes, std::memory_order_release);
+    }
+
+    [[nodiscard]] size_t freeSpace() const {
+        return Capacity - (_tail.load(std::memory_order_relaxed) - _head.load(std::memory_order_acquire));
+    }
+
+    // ----- consumer -----
+
+    [[nodiscard]] size_t available() const {
+        return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_relaxed);
+    }
+
+    size_t read(uint8_t* data, size_t size) {
+        size_t copied = 0;
+        for (int segment = 0; segment < 2 && copied < size; segment++) {
+            size_t region = 0;
+            const uint8_t* in = prepareRead(region);
+            const size_t toCopy = std::min(region, size - copied);
+            if (toCopy == 0) {
+                break;
+            }
+            std::memcpy(data + copied, in, toCopy);
+            commitRead(toCopy);
+            copied += toCopy;
+        }
+        return copied;
+    }
+
+    // Contiguous readable bytes at the read position. Release them with commitRead().
+    const uint8_t* prepareRead(size_t& size) {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        const size_t start = head & MASK;
+        if (_cachedTail - head < Capacity - start) {
+            _cachedTail = _tail.load(std::memory_order_acquire);
+        }
+        size = std::min(_cachedTail - head, Capacity - start);
+        return _buffer.data() + start;
+    }
+
+    void commitRead(size_t bytes) {
+        _head.store(_head.load(std::memory_order_relaxed) + bytes, std::memory_order_release);
+    }
+
+  private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    // Consumer line: its position and its view of the producer's
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> _head{0};
+    size_t _cachedTail = 0;
+    // Producer line
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> _tail{0};
+    size_t _cachedHead = 0;
+
+    alignas(CACHE_LINE_SIZE) std::array<uint8_t, Capacity> _buffer;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "Communication.h"
+#include "SpscRingBuffer.h"
+
+// Communication backed by two SPSC rings, for handing bytes between an ISR or I/O thread and the thread that
+// owns this object. The I/O side produces into rx() and consumes from tx(); read(), available() and write()
+// work on the other ends, so it can be wrapped by SevenBitEncodedCommunication as is.
+template <size_t RxCapacity, size_t TxCapacity> class SpscRingCommunication final : public Communication {
+  public:
+    SpscRingBuffer<RxCapacity>& rx() noexcept {
+        return _rx;
+    }
+
+    SpscRingBuffer<TxCapacity>& tx() noexcept {
+        return _tx;
+    }
+
+    // Bytes of writes dropped because the tx ring did not have room for them
+    [[nodiscard]] size_t droppedTxBytes() const noexcept {
+        return _droppedTxBytes.load(std::memory_order_relaxed);
+    }
+
+  private:
+    // A write goes in whole or not at all, so a frame is never cut short in the middle of the stream
+    void writeImpl(const uint8_t* data, size_t size) override {
+        if (_tx.freeSpace() < size) {
+            _droppedTxBytes.store(_droppedTxBytes.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+            return;
+        }
+        _tx.write(data, size);
+    }
+
+    size_t availableImpl() override {
+        return _rx.available();
+    }
+
+    size_t readImpl(uint8_t* data, size_t size) override {
+        return _rx.read(data, size);
+    }
+
+    SpscRingBuffer<RxCapacity> _rx;
+    SpscRingBuffer<TxCapacity> _tx;
+    std::atomic<size_t> _droppedTxBytes{0};
+};
@@ -0,0 +1,46 @@
+#include "IntegralCommunication/EpollPoller.h"
+
+#if defined(__linux__)
+
+#include <cerrno>
+#include <unistd.h>
+
+EpollPoller::EpollPoller() : _fd(::epoll_create1(EPOLL_CLOEXEC)) {}
+
+EpollPoller::~EpollPoller() {
+    if (_fd >= 0) {
+        ::close(_fd);
+    }
+}
+
+bool EpollPoller::valid() const noexcept {
+    return _fd >= 0;
+}
+
+bool EpollPoller::add(int fd, uint32_t events, void* context) {
+    epoll_event event{};
+    event.events = events;
+    event.data.ptr = context;
+    return ::epoll_ctl(_fd, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+bool EpollPoller::modify(int fd, uint32_t events, void* context) {
+    epoll_event event{};
+    event.events = events;
+    event.data.ptr = context;
+    return ::epoll_ctl(_fd, EPOLL_CTL_MOD, fd, &event) == 0;
+}
+
+bool EpollPoller::remove(int fd) {
+    return ::epoll_ctl(_fd, EPOLL_CTL_DEL, fd, nullptr) == 0;
+}
+
+int EpollPoller::wait(epoll_event* events, int maxEvents, int timeoutMs) {
+    const int ready = ::epoll_wait(_fd, events, maxEvents, timeoutMs);
+    if (ready < 0 && errno == EINTR) {
+        return 0;
+    }
+    return ready;
+}
+
+#endif
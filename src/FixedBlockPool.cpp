@@ -0,0 +1,103 @@
+#include "IntegralCommunication/FixedBlockPool.h"
+
+#include <cstring>
+
+namespace {
+    // Blocks need not be aligned for a pointer, so the link is copied in and out
+    uint8_t* nextBlock(const uint8_t* block) {
+        uint8_t* next = nullptr;
+        std::memcpy(&next, block, sizeof(next));
+        return next;
+    }
+
+    void setNextBlock(uint8_t* block, uint8_t* next) {
+        std::memcpy(block, &next, sizeof(next));
+    }
+} // namespace
+
+FixedBlockPool::FixedBlockPool(uint8_t* memory, size_t blockSize, size_t blockCount)
+    : _blockSize(blockSize), _blockCount(blockSize >= MIN_BLOCK_SIZE ? blockCount : 0), _freeBlocks(_blockCount),
+      _lowWater(_blockCount) {
+    // Chained back to front, so the first acquire() returns the start of memory
+    for (size_t i = _blockCount; i > 0; i--) {
+        uint8_t* block = memory + (i - 1) * _blockSize;
+        setNextBlock(block, _freeList);
+        _freeList = block;
+    }
+}
+
+bool FixedBlockPool::valid() const noexcept {
+    return _blockSize >= MIN_BLOCK_SIZE;
+}
+
+uint8_t* FixedBlockPool::acquire() noexcept {
+    if (_freeList == nullptr) {
+        _exhaustions++;
+        return nullptr;
+    }
+
+    uint8_t* block = _freeList;
+    _freeList = nextBlock(block);
+    _freeBlocks--;
+    if (_freeBlocks < _lowWater) {
+        _lowWater = _freeBlocks;
+    }
+    return block;
+}
+
+void FixedBlockPool::release(uint8_t* block) {
+    setNextBlock(block, _freeList);
+    _freeList = block;
+    _freeBlocks++;
+
+    // Detached first: a waiter may acquire, release or wait again from its callback
+    Waiter* waiter = _waiters;
+    _waiters = nullptr;
+    while (waiter != nullptr) {
+        Waiter* next = waiter->_nextWaiter;
+        waiter->_nextWaiter = nullptr;
+        waiter->_waiting = false;
+        waiter->onBlockReleased();
+        waiter = next;
+    }
+}
+
+void FixedBlockPool::wait(Waiter& waiter) noexcept {
+    if (waiter._waiting) {
+        return;
+    }
+    waiter._waiting = true;
+    waiter._nextWaiter = _waiters;
+    _waiters = &waiter;
+}
+
+void FixedBlockPool::cancelWait(Waiter& waiter) noexcept {
+    for (Waiter** link = &_waiters; *link != nullptr; link = &(*link)->_nextWaiter) {
+        if (*link == &waiter) {
+            *link = waiter._nextWaiter;
+            break;
+        }
+    }
+    waiter._nextWaiter = nullptr;
+    waiter._waiting = false;
+}
+
+size_t FixedBlockPool::blockSize() const noexcept {
+    return _blockSize;
+}
+
+size_t FixedBlockPool::blockCount() const noexcept {
+    return _blockCount;
+}
+
+size_t FixedBlockPool::freeBlocks() const noexcept {
+    return _freeBlocks;
+}
+
+size_t FixedBlockPool::lowWater() const noexcept {
+    return _lowWater;
+}
+
+size_t FixedBlockPool::exhaustions() const noexcept {
+    return _exhaustions;
+}
@@ -0,0 +1,212 @@
+#include "IntegralCommunication/FrameReactor.h"
+
+#if defined(__linux__)
+
+#include <utility>
+
+namespace {
+    constexpr uint32_t READ_EVENTS = EPOLLIN | EPOLLRDHUP;
+    constexpr uint32_t HANGUP_EVENTS = EPOLLRDHUP | EPOLLHUP;
+} // namespace
+
+ReactorLink::ReactorLink(PosixFdCommunication& transport)
+    : _transport(transport), _frameHandler([](const SevenBitMessageView&) {}) {}
+
+ReactorLink::~ReactorLink() {
+    if (_reactor != nullptr) {
+        _reactor->remove(*this);
+    }
+}
+
+void ReactorLink::onFrame(FrameHandler handler) {
+    _frameHandler = std::move(handler);
+}
+
+void ReactorLink::onTxDrained(EventHandler handler) {
+    _txDrainedHandler = std::move(handler);
+}
+
+void ReactorLink::onClosed(EventHandler handler) {
+    _closedHandler = std::move(handler);
+}
+
+bool ReactorLink::writeMessage(const uint8_t* data, size_t length) {
+    if (_closed || !encodeMessage(data, length)) {
+        return false;
+    }
+
+    const PosixFdCommunication::WriteStatus status = _transport.lastWriteStatus();
+    if (status == PosixFdCommunication::WriteStatus::Queued) {
+        watchWritable(true);
+    }
+    return status == PosixFdCommunication::WriteStatus::Complete ||
+           status == PosixFdCommunication::WriteStatus::Queued;
+}
+
+PosixFdCommunication& ReactorLink::transport() noexcept {
+    return _transport;
+}
+
+bool ReactorLink::closed() const noexcept {
+    return _closed;
+}
+
+void ReactorLink::pauseReading() {
+    if (_readingPaused) {
+        return;
+    }
+    _readingPaused = true;
+    if (_reactor != nullptr) {
+        _reactor->updateReadEvents(*this);
+    }
+}
+
+void ReactorLink::resumeReading() {
+    if (!_readingPaused) {
+        return;
+    }
+    _readingPaused = false;
+    if (_reactor != nullptr) {
+        _reactor->updateReadEvents(*this);
+    }
+}
+
+void ReactorLink::handleEvents(uint32_t events) {
+    if ((events & EPOLLOUT) != 0 && _transport.flushPending()) {
+        watchWritable(false);
+        if (_txDrainedHandler) {
+            _txDrainedHandler();
+        }
+    }
+
+    if ((events & (READ_EVENTS | HANGUP_EVENTS | EPOLLERR)) == 0) {
+        return;
+    }
+
+    readFrames(_frameHandler);
+
+    // After a hangup the rest of the bytes are delivered first, one rx buffer per event
+    const bool hungUp = (events & HANGUP_EVENTS) != 0 && _transport.available() == 0;
+    if (_transport.closed() || hungUp || (events & EPOLLERR) != 0) {
+        close();
+    }
+}
+
+void ReactorLink::watchWritable(bool enabled) {
+    if (_watchingWritable == enabled || _reactor == nullptr) {
+        return;
+    }
+    if (_reactor->watchWritable(*this, enabled)) {
+        _watchingWritable = enabled;
+    }
+}
+
+void ReactorLink::close() {
+    _closed = true;
+    if (_reactor != nullptr) {
+        _reactor->remove(*this);
+    }
+    // Moved out first: the handler may destroy this link and with it the handler itself
+    const EventHandler handler = std::move(_closedHandler);
+    if (handler) {
+        handler();
+    }
+}
+
+bool FrameReactor::valid() const noexcept {
+    return _poller.valid();
+}
+
+bool FrameReactor::add(ReactorLink& link) {
+    if (link._reactor != nullptr || link._closed || !_poller.add(link._transport.readFd(), readEvents(link), &link)) {
+        return false;
+    }
+
+    link._reactor = this;
+    link._readFd = link._transport.readFd();
+    link._writeFd = link._transport.writeFd();
+    _links++;
+    if (link._transport.pendingTxBytes() > 0) {
+        link.watchWritable(true);
+    }
+    return true;
+}
+
+bool FrameReactor::remove(ReactorLink& link) {
+    if (link._reactor != this) {
+        return false;
+    }
+
+    _poller.remove(link._readFd);
+    if (link._watchingWritable && link._writeFd != link._readFd) {
+        _poller.remove(link._writeFd);
+    }
+    link._watchingWritable = false;
+    link._reactor = nullptr;
+    _links--;
+
+    // Events of the current batch must not reach a link that may be gone
+    for (int i = _next; i < _ready; i++) {
+        if (_events[i].data.ptr == &link) {
+            _events[i].data.ptr = nullptr;
+        }
+    }
+    return true;
+}
+
+int FrameReactor::runOnce(int timeoutMs) {
+    _ready = _poller.wait(_events, MAX_EVENTS, timeoutMs);
+    if (_ready < 0) {
+        _ready = 0;
+        return -1;
+    }
+
+    int handled = 0;
+    _next = 0;
+    while (_next < _ready) {
+        const epoll_event& event = _events[_next++];
+        auto* link = static_cast<ReactorLink*>(event.data.ptr);
+        if (link != nullptr) {
+            link->handleEvents(event.events);
+            handled++;
+        }
+    }
+    _ready = 0;
+    _next = 0;
+    return handled;
+}
+
+void FrameReactor::run() {
+    _stopped = false;
+    while (!_stopped && _links > 0 && runOnce(-1) >= 0) {
+    }
+}
+
+void FrameReactor::stop() noexcept {
+    _stopped = true;
+}
+
+size_t FrameReactor::linkCount() const noexcept {
+    return _links;
+}
+
+// A link whose read and write descriptors differ registers the write one only while it has queued bytes
+bool FrameReactor::watchWritable(ReactorLink& link, bool enabled) {
+    if (link._readFd == link._writeFd) {
+        return _poller.modify(link._readFd, readEvents(link) | (enabled ? static_cast<uint32_t>(EPOLLOUT) : 0u), &link);
+    }
+    return enabled ? _poller.add(link._writeFd, EPOLLOUT, &link) : _poller.remove(link._writeFd);
+}
+
+bool FrameReactor::updateReadEvents(ReactorLink& link) {
+    const bool sharedWritable = link._watchingWritable && link._readFd == link._writeFd;
+    return _poller.modify(link._readFd, readEvents(link) | (sharedWritable ? static_cast<uint32_t>(EPOLLOUT) : 0u),
+                          &link);
+}
+
+// Events of the read descriptor, without EPOLLOUT
+uint32_t FrameReactor::readEvents(const ReactorLink& link) noexcept {
+    return link._readingPaused ? 0u : READ_EVENTS;
+}
+
+#endif
@@ -0,0 +1,215 @@
+#include "IntegralCommunication/PosixFdCommunication.h"
+
+#if defined(__linux__)
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace {
+    void setNonBlocking(int fd) {
+        const int flags = ::fcntl(fd, F_GETFL);
+        if (flags >= 0 && (flags & O_NONBLOCK) == 0) {
+            ::fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+        }
+    }
+
+    bool wouldBlock(int error) {
+        return error == EAGAIN || error == EWOULDBLOCK;
+    }
+
+    size_t totalLength(const iovec* buffers, size_t count) {
+        size_t total = 0;
+        for (size_t i = 0; i < count; i++) {
+            total += buffers[i].iov_len;
+        }
+        return total;
+    }
+} // namespace
+
+PosixFdCommunication::PosixFdCommunication(int fd, uint8_t* backlog, size_t backlogSize)
+    : PosixFdCommunication(fd, fd, backlog, backlogSize) {}
+
+PosixFdCommunication::PosixFdCommunication(int readFd, int writeFd, uint8_t* backlog, size_t backlogSize)
+    : _readFd(readFd), _writeFd(writeFd), _backlog(backlog), _backlogSize(backlogSize) {
+    setNonBlocking(_readFd);
+    setNonBlocking(_writeFd);
+}
+
+PosixFdCommunication::PosixFdCommunication(int fd, FixedBlockPool& backlogPool)
+    : PosixFdCommunication(fd, fd, backlogPool) {}
+
+PosixFdCommunication::PosixFdCommunication(int readFd, int writeFd, FixedBlockPool& backlogPool)
+    : PosixFdCommunication(readFd, writeFd, nullptr, backlogPool.blockSize()) {
+    _backlogPool = &backlogPool;
+}
+
+PosixFdCommunication::~PosixFdCommunication() {
+    _backlogLength = 0;
+    releaseBacklog();
+}
+
+PosixFdCommunication::WriteStatus PosixFdCommunication::writeVectored(const iovec* buffers, size_t count) {
+    if (!flushPending()) {
+        // Still blocked: queue behind the backlog to keep the byte order, or drop the write as a whole
+        _lastWriteStatus = queue(buffers, count, 0);
+        return _lastWriteStatus;
+    }
+
+    if (!reserveBacklog()) {
+        _droppedTxBytes += totalLength(buffers, count);
+        _lastWriteStatus = WriteStatus::Dropped;
+        return _lastWriteStatus;
+    }
+
+    ssize_t written = 0;
+    do {
+        written = ::writev(_writeFd, buffers, static_cast<int>(std::min<size_t>(count, IOV_MAX)));
+    } while (written < 0 && errno == EINTR);
+
+    if (written < 0) {
+        if (!wouldBlock(errno)) {
+            _lastError = errno;
+            _droppedTxBytes += totalLength(buffers, count);
+            _lastWriteStatus = WriteStatus::Error;
+            releaseBacklog();
+            return _lastWriteStatus;
+        }
+        written = 0;
+    }
+
+    _lastWriteStatus = queue(buffers, count, static_cast<size_t>(written));
+    releaseBacklog();
+    return _lastWriteStatus;
+}
+
+bool PosixFdCommunication::flushPending() {
+    while (_backlogLength > 0) {
+        const ssize_t written = ::write(_writeFd, _backlog, _backlogLength);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (!wouldBlock(errno)) {
+                _lastError = errno;
+            }
+            return false;
+        }
+
+        const auto sent = static_cast<size_t>(written);
+        if (sent < _backlogLength) {
+            std::memmove(_backlog, _backlog + sent, _backlogLength - sent);
+        }
+        _backlogLength -= sent;
+    }
+    releaseBacklog();
+    return true;
+}
+
+int PosixFdCommunication::readFd() const noexcept {
+    return _readFd;
+}
+
+int PosixFdCommunication::writeFd() const noexcept {
+    return _writeFd;
+}
+
+size_t PosixFdCommunication::pendingTxBytes() const noexcept {
+    return _backlogLength;
+}
+
+size_t PosixFdCommunication::droppedTxBytes() const noexcept {
+    return _droppedTxBytes;
+}
+
+PosixFdCommunication::WriteStatus PosixFdCommunication::lastWriteStatus() const noexcept {
+    return _lastWriteStatus;
+}
+
+int PosixFdCommunication::lastError() const noexcept {
+    return _lastError;
+}
+
+bool PosixFdCommunication::closed() const noexcept {
+    return _closed;
+}
+
+void PosixFdCommunication::writeImpl(const uint8_t* data, size_t size) {
+    const iovec buffer{const_cast<uint8_t*>(data), size};
+    writeVectored(&buffer, 1);
+}
+
+size_t PosixFdCommunication::availableImpl() {
+    int available = 0;
+    if (::ioctl(_readFd, FIONREAD, &available) < 0) {
+        _lastError = errno;
+        return 0;
+    }
+    return static_cast<size_t>(available);
+}
+
+size_t PosixFdCommunication::readImpl(uint8_t* data, size_t size) {
+    for (;;) {
+        const ssize_t received = ::read(_readFd, data, size);
+        if (received >= 0) {
+            _closed = _closed || (received == 0 && size > 0);
+            return static_cast<size_t>(received);
+        }
+        if (errno != EINTR) {
+            if (!wouldBlock(errno)) {
+                _lastError = errno;
+            }
+            return 0;
+        }
+    }
+}
+
+// Keeps the bytes of buffers after the first skip ones. With the backlog empty before the write, they fit
+// unless the write was larger than the whole backlog; then the rest is dropped and the write arrives cut short.
+PosixFdCommunication::WriteStatus PosixFdCommunication::queue(const iovec* buffers, size_t count, size_t skip) {
+    const size_t remaining = totalLength(buffers, count) - skip;
+    if (remaining == 0) {
+        return WriteStatus::Complete;
+    }
+    if (remaining > _backlogSize - _backlogLength) {
+        _droppedTxBytes += remaining;
+        return WriteStatus::Dropped;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const size_t length = buffers[i].iov_len;
+        if (skip >= length) {
+            skip -= length;
+            continue;
+        }
+        std::memcpy(_backlog + _backlogLength, static_cast<const uint8_t*>(buffers[i].iov_base) + skip,
+                    length - skip);
+        _backlogLength += length - skip;
+        skip = 0;
+    }
+    return WriteStatus::Queued;
+}
+
+// A pool-backed backlog is borrowed before every write, so the part the kernel does not take always has a place
+// to go; without a free block the write is dropped as a whole
+bool PosixFdCommunication::reserveBacklog() {
+    if (_backlogPool == nullptr || _backlog != nullptr) {
+        return true;
+    }
+    _backlog = _backlogPool->acquire();
+    return _backlog != nullptr;
+}
+
+// Gives a pool-backed backlog back once it is empty
+void PosixFdCommunication::releaseBacklog() {
+    if (_backlogPool != nullptr && _backlog != nullptr && _backlogLength == 0) {
+        _backlogPool->release(_backlog);
+        _backlog = nullptr;
+    }
+}
+
+#endif
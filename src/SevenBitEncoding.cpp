@@ -1,20 +1,172 @@
 #include "IntegralCommunication/SevenBitEncoding.h"
+#include "SevenBitEncodingSimd.h"
+#include "SevenBitEncodingWord.h"
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 
 namespace SevenBitEncoding {
-    inline constexpr uint8_t LAST_SEVEN_BITS = 0x7F;
-    inline constexpr uint8_t FIRST_BIT = 0x80;
-    inline constexpr int ENCODING_SIZE = 7;
     inline constexpr int MAX_SHIFTS_FOR_VALUE = 32;
 
-    size_t getEncodedSize(uint32_t value) {
-        size_t size = 0;
-        do {
-            size++;
-            value >>= ENCODING_SIZE;
-        } while (value > 0);
-        return size;
+    namespace {
+        struct BlockKernels {
+            Kernel kind;
+            detail::EncodeBlocksFn encodeBlocks;
+            detail::DecodeBlocksFn decodeBlocks;
+            detail::FindLastByteFn findLastByte;
+            detail::DecodeValuesFn decodeValues;
+            detail::DecodeValues64Fn decodeValues64;
+        };
+
+        BlockKernels kernelsFor(Kernel kernel) {
+#if INTEGRALCOMM_X86_SIMD
+            switch (kernel) {
+            case Kernel::Avx2:
+                return {Kernel::Avx2,
+                        detail::encodeBlocksAvx2,
+                        detail::decodeBlocksAvx2,
+                        detail::findLastByteAvx2,
+                        detail::decodeValuesSsse3,
+                        detail::decodeValuesSsse3};
+            case Kernel::Ssse3:
+                return {Kernel::Ssse3,
+                        detail::encodeBlocksSsse3,
+                        detail::decodeBlocksSsse3,
+                        detail::findLastByteSse2,
+                        detail::decodeValuesSsse3,
+                        detail::decodeValuesSsse3};
+            case Kernel::Scalar:
+                break;
+            }
+#else
+            (void) kernel;
+#endif
+#if INTEGRALCOMM_SWAR
+            return {Kernel::Scalar, nullptr, nullptr, detail::findLastByteWords, nullptr, nullptr};
+#else
+            return {Kernel::Scalar, nullptr, nullptr, nullptr, nullptr, nullptr};
+#endif
+        }
+
+        Kernel bestKernel() {
+            if (isKernelSupported(Kernel::Avx2)) {
+                return Kernel::Avx2;
+            }
+            if (isKernelSupported(Kernel::Ssse3)) {
+                return Kernel::Ssse3;
+            }
+            return Kernel::Scalar;
+        }
+
+        BlockKernels& blockKernels() {
+            static BlockKernels kernels = kernelsFor(bestKernel());
+            return kernels;
+        }
+
+        // Decodes as much of inputBuffer as fits in outputBuffer. With Validate set, continuation is cleared if
+        // a byte before the last input byte is missing its continuation bit.
+        template <bool Validate>
+        size_t decodeBytes(const uint8_t* inputBuffer, size_t inputLength, uint8_t* outputBuffer,
+                           size_t outputLength, bool& continuation) {
+            size_t decoded = 0;
+            size_t encodedIndex = 0;
+
+            // Blocks never include the last input byte, which is the only one allowed to lack the MSB
+            const BlockKernels& kernels = blockKernels();
+            if (kernels.decodeBlocks != nullptr && inputLength > 0 && outputLength >= detail::DECODE_WRITE_SLACK) {
+                const size_t blocks = std::min((inputLength - 1) / detail::ENCODED_BLOCK_SIZE,
+                                               (outputLength - detail::DECODE_WRITE_SLACK) / detail::DECODED_BLOCK_SIZE);
+                if (blocks > 0) {
+                    continuation = kernels.decodeBlocks(inputBuffer, blocks, outputBuffer) && continuation;
+                    encodedIndex = blocks * detail::ENCODED_BLOCK_SIZE;
+                    decoded = blocks * detail::DECODED_BLOCK_SIZE;
+                }
+            }
+
+            if (Validate) {
+                for (size_t i = encodedIndex; i + 1 < inputLength; i++) {
+                    continuation = continuation && !isLastByte(inputBuffer[i]);
+                }
+            }
+
+#if INTEGRALCOMM_SWAR
+            while (encodedIndex + detail::ENCODED_GROUP_SIZE <= inputLength &&
+                   decoded + detail::GROUP_SIZE <= outputLength) {
+                detail::decodeGroup(inputBuffer + encodedIndex, outputBuffer + decoded);
+                encodedIndex += detail::ENCODED_GROUP_SIZE;
+                decoded += detail::GROUP_SIZE;
+            }
+#endif
+
+            return decoded + detail::decodeSeptets(inputBuffer + encodedIndex, inputLength - encodedIndex,
+                                                   outputBuffer + decoded, outputLength - decoded);
+        }
+
+        // Same bytes as encodeValue, for either width
+        template <typename T> size_t encodeVarint(T value, uint8_t* output) {
+            size_t index = 0;
+            while (value >= FIRST_BIT) {
+                output[index++] = static_cast<uint8_t>(value | FIRST_BIT);
+                value >>= ENCODING_SIZE;
+            }
+            output[index++] = static_cast<uint8_t>(value);
+            return index;
+        }
+
+        // Lets the kernel take the runs of short values and decodes whatever it stops at one value at a time.
+        template <typename T, typename KernelFn, typename DecodeFn>
+        size_t decodeVarints(const uint8_t* input, const size_t inputSize, T* values, const size_t count,
+                             size_t& consumedBytes, KernelFn kernel, DecodeFn decodeOne, const size_t maxSize) {
+            size_t position = 0;
+            size_t decoded = 0;
+            while (decoded < count && position < inputSize) {
+                if (kernel != nullptr) {
+                    size_t used = 0;
+                    decoded += kernel(input + position, inputSize - position, values + decoded, count - decoded, used);
+                    position += used;
+                    if (decoded == count || position == inputSize) {
+                        break;
+                    }
+                }
+
+                size_t used = 0;
+                const T value = decodeOne(input + position, inputSize - position, used);
+                if (!isLastByte(input[position + used - 1]) && used < maxSize) {
+                    break; // cut off by the end of input
+                }
+                values[decoded++] = value;
+                position += used;
+            }
+            consumedBytes = position;
+            return decoded;
+        }
+    } // namespace
+
+    Kernel activeKernel() {
+        return blockKernels().kind;
+    }
+
+    bool isKernelSupported(const Kernel kernel) {
+        switch (kernel) {
+        case Kernel::Scalar:
+            return true;
+#if INTEGRALCOMM_X86_SIMD
+        case Kernel::Ssse3:
+            return detail::cpuSupportsSsse3();
+        case Kernel::Avx2:
+            return detail::cpuSupportsAvx2();
+#endif
+        default:
+            return false;
+        }
+    }
+
+    bool selectKernel(const Kernel kernel) {
+        if (!isKernelSupported(kernel)) {
+            return false;
+        }
+        blockKernels() = kernelsFor(kernel);
+        return true;
     }
 
     void encodeValue(uint32_t value, uint8_t* output) {
@@ -30,6 +182,11 @@ namespace SevenBitEncoding {
     }
 
     uint32_t decodeValue(const uint8_t* input, size_t inputSize, size_t& consumedBytes) {
+#if INTEGRALCOMM_SWAR && INTEGRALCOMM_WORD_LOADS
+        if (inputSize >= sizeof(uint64_t)) {
+            return detail::decodeValueWord(input, consumedBytes);
+        }
+#endif
         uint32_t length = 0;
         size_t shift = 0;
         consumedBytes = 0;
@@ -54,63 +211,189 @@ namespace SevenBitEncoding {
         return length;
     }
 
-    size_t getEncodedBufferSize(const size_t bufferLength) {
-        return (bufferLength > 0) ? bufferLength + ((bufferLength - 1) / ENCODING_SIZE) + 1 : 1;
+    void encodeValue64(const uint64_t value, uint8_t* output) {
+        encodeVarint(value, output);
     }
 
-    size_t encodeBuffer(const uint8_t* inputBuffer, const size_t inputLength, uint8_t* outputBuffer) {
-        if (inputLength == 0) {
-            return 0;
+    uint64_t decodeValue64(const uint8_t* input, size_t inputSize, size_t& consumedBytes) {
+        uint64_t value = 0;
+        consumedBytes = 0;
+
+        for (size_t i = 0; i < inputSize && i < MAX_ENCODED_VALUE64_SIZE; i++) {
+            const uint8_t byte = input[i];
+            value |= static_cast<uint64_t>(byte & LAST_SEVEN_BITS) << (i * ENCODING_SIZE);
+            consumedBytes++;
+            if (isLastByte(byte)) {
+                break;
+            }
+        }
+        return value;
+    }
+
+    size_t encodeValues(const uint32_t* values, const size_t count, uint8_t* output) {
+        size_t written = 0;
+        for (size_t i = 0; i < count; i++) {
+            written += encodeVarint(values[i], output + written);
+        }
+        return written;
+    }
+
+    size_t encodeValues(const uint64_t* values, const size_t count, uint8_t* output) {
+        size_t written = 0;
+        for (size_t i = 0; i < count; i++) {
+            written += encodeVarint(values[i], output + written);
+        }
+        return written;
+    }
+
+    size_t encodeSignedValues(const int32_t* values, const size_t count, uint8_t* output) {
+        size_t written = 0;
+        for (size_t i = 0; i < count; i++) {
+            written += encodeVarint(zigZagEncode(values[i]), output + written);
+        }
+        return written;
+    }
+
+    size_t encodeSignedValues(const int64_t* values, const size_t count, uint8_t* output) {
+        size_t written = 0;
+        for (size_t i = 0; i < count; i++) {
+            written += encodeVarint(zigZagEncode64(values[i]), output + written);
+        }
+        return written;
+    }
+
+    size_t decodeValues(const uint8_t* input, const size_t inputSize, uint32_t* values, const size_t count,
+                        size_t& consumedBytes) {
+        return decodeVarints(input, inputSize, values, count, consumedBytes, blockKernels().decodeValues,
+                             decodeValue, MAX_ENCODED_VALUE_SIZE);
+    }
+
+    size_t decodeValues(const uint8_t* input, const size_t inputSize, uint64_t* values, const size_t count,
+                        size_t& consumedBytes) {
+        return decodeVarints(input, inputSize, values, count, consumedBytes, blockKernels().decodeValues64,
+                             decodeValue64, MAX_ENCODED_VALUE64_SIZE);
+    }
+
+    // The signed variants decode in place: int32_t and uint32_t may alias each other.
+    size_t decodeSignedValues(const uint8_t* input, const size_t inputSize, int32_t* values, const size_t count,
+                              size_t& consumedBytes) {
+        auto* raw = reinterpret_cast<uint32_t*>(values);
+        const size_t decoded = decodeValues(input, inputSize, raw, count, consumedBytes);
+        for (size_t i = 0; i < decoded; i++) {
+            values[i] = zigZagDecode(raw[i]);
+        }
+        return decoded;
+    }
+
+    size_t decodeSignedValues(const uint8_t* input, const size_t inputSize, int64_t* values, const size_t count,
+                              size_t& consumedBytes) {
+        auto* raw = reinterpret_cast<uint64_t*>(values);
+        const size_t decoded = decodeValues(input, inputSize, raw, count, consumedBytes);
+        for (size_t i = 0; i < decoded; i++) {
+            values[i] = zigZagDecode64(raw[i]);
         }
+        return decoded;
+    }
+
+    size_t detail::encodeBufferKernels(const uint8_t* inputBuffer, const size_t inputLength, uint8_t* outputBuffer) {
+        size_t i = 0;
         size_t outIndex = 0;
-        uint8_t carry = 0;
-        int carryBits = 0;
-        for (size_t i = 0; i < inputLength; i++) {
-            uint8_t current = inputBuffer[i];
-            uint8_t septet = carry | (current >> (carryBits + 1));
-            outputBuffer[outIndex++] = septet | FIRST_BIT;
-            carryBits++;
-            carry = (current & leftMask(carryBits)) << (ENCODING_SIZE - carryBits);
-            if (carryBits == ENCODING_SIZE) {
-                outputBuffer[outIndex++] = carry | FIRST_BIT;
-                carry = 0;
-                carryBits = 0;
-            }
+
+        // Whole blocks and groups leave no carry behind, so the byte loop below picks up where they stopped
+        const BlockKernels& kernels = blockKernels();
+        if (kernels.encodeBlocks != nullptr && inputLength >= detail::ENCODE_READ_SLACK) {
+            const size_t blocks = (inputLength - detail::ENCODE_READ_SLACK) / detail::DECODED_BLOCK_SIZE;
+            kernels.encodeBlocks(inputBuffer, blocks, outputBuffer);
+            i = blocks * detail::DECODED_BLOCK_SIZE;
+            outIndex = blocks * detail::ENCODED_BLOCK_SIZE;
         }
-        if (carryBits != 0) {
-            uint8_t septet = carry;
-            outputBuffer[outIndex++] = septet;
+
+#if INTEGRALCOMM_SWAR
+        for (; inputLength - i >= detail::GROUP_SIZE; i += detail::GROUP_SIZE) {
+            detail::encodeGroup(inputBuffer + i, outputBuffer + outIndex);
+            outIndex += detail::ENCODED_GROUP_SIZE;
         }
+#endif
+
+        outIndex += detail::encodeSeptets(inputBuffer + i, inputLength - i, outputBuffer + outIndex);
         outputBuffer[outIndex - 1] &= LAST_SEVEN_BITS;
         return outIndex;
     }
 
-    size_t decodeBuffer(const uint8_t* inputBuffer, size_t inputLength, uint8_t* outputBuffer, size_t outputLength) {
-        if (inputBuffer == nullptr || outputLength == 0) {
+    size_t encodeBufferInPlace(uint8_t* buffer, const size_t inputLength) {
+        if (inputLength == 0) {
             return 0;
         }
-        size_t decoded = 0;
-        size_t encodedIndex = 0;
-        int bitShiftIndex = 0;
-        while (decoded < outputLength && encodedIndex + 1 < inputLength) {
-            uint8_t currentByte = inputBuffer[encodedIndex] & LAST_SEVEN_BITS;
-            uint8_t nextByte = inputBuffer[encodedIndex + 1] & LAST_SEVEN_BITS;
-            int bits = bitShiftIndex + 1;
-            uint8_t carry = (nextByte >> (ENCODING_SIZE - bits)) & ((1 << bits) - 1);
-            uint8_t upperPart = currentByte & ((1 << (ENCODING_SIZE - bitShiftIndex)) - 1);
-            uint8_t value = (upperPart << bits) | carry;
-            outputBuffer[decoded++] = value;
-            bitShiftIndex++;
-            encodedIndex++;
-            if (bitShiftIndex == ENCODING_SIZE) {
-                encodedIndex++;
-                bitShiftIndex = 0;
+        const size_t encodedLength = getEncodedBufferSize(inputLength);
+        const size_t groups = inputLength / detail::GROUP_SIZE;
+
+        // Output byte j only needs input bytes up to index j, so filling from the back never overwrites input
+        // that is still to be read. The partial last group goes septet by septet.
+        for (size_t j = encodedLength; j-- > groups * detail::ENCODED_GROUP_SIZE;) {
+            const size_t bit = j * ENCODING_SIZE;
+            const size_t byte = bit / 8;
+            const size_t offset = bit % 8;
+            unsigned window = static_cast<unsigned>(buffer[byte]) << 8;
+            if (offset > 1 && byte + 1 < inputLength) {
+                window |= buffer[byte + 1]; // the septet continues into the next byte
             }
+            buffer[j] = static_cast<uint8_t>((window >> (9 - offset)) & LAST_SEVEN_BITS) | FIRST_BIT;
         }
-        return decoded;
+
+        for (size_t group = groups; group-- > 0;) {
+            detail::encodeGroup(buffer + (group * detail::GROUP_SIZE), buffer + (group * detail::ENCODED_GROUP_SIZE));
+        }
+
+        buffer[encodedLength - 1] &= LAST_SEVEN_BITS;
+        return encodedLength;
+    }
+
+    size_t detail::decodeBufferKernels(const uint8_t* inputBuffer, size_t inputLength, uint8_t* outputBuffer,
+                                       size_t outputLength) {
+        bool continuation = true;
+        return decodeBytes<false>(inputBuffer, inputLength, outputBuffer, outputLength, continuation);
+    }
+
+    DecodeStatus decodeBuffer(const uint8_t* inputBuffer, size_t inputLength, uint8_t* outputBuffer,
+                              size_t outputLength, size_t& decodedLength) {
+        decodedLength = 0;
+        if (inputLength == 0) {
+            return DecodeStatus::Ok;
+        }
+        if (inputBuffer == nullptr || outputBuffer == nullptr) {
+            return DecodeStatus::InvalidArgument;
+        }
+        // A last group holding a single septet carries only padding bits
+        if (inputLength % (ENCODING_SIZE + 1) == 1) {
+            return DecodeStatus::InvalidLength;
+        }
+        if (!isLastByte(inputBuffer[inputLength - 1])) {
+            return DecodeStatus::MissingTerminator;
+        }
+        const size_t expected = inputLength - ((inputLength + ENCODING_SIZE) / (ENCODING_SIZE + 1));
+        if (expected > outputLength) {
+            return DecodeStatus::OutputTooSmall;
+        }
+
+        bool continuation = true;
+        const size_t decoded = decodeBytes<true>(inputBuffer, inputLength, outputBuffer, expected, continuation);
+        if (!continuation) {
+            return DecodeStatus::MissingContinuationBit;
+        }
+        decodedLength = decoded;
+        return DecodeStatus::Ok;
     }
 
-    bool isLastByte(const uint8_t byte) {
-        return (byte & FIRST_BIT) == 0;
+    size_t findLastByte(const uint8_t* buffer, const size_t length) {
+        const BlockKernels& kernels = blockKernels();
+        if (kernels.findLastByte != nullptr) {
+            return kernels.findLastByte(buffer, length);
+        }
+        for (size_t i = 0; i < length; i++) {
+            if (isLastByte(buffer[i])) {
+                return i;
+            }
+        }
+        return length;
     }
 } // namespace SevenBitEncoding
\ No newline at end of file
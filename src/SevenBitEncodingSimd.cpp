@@ -0,0 +1,351 @@
+#include "SevenBitEncodingSimd.h"
+
+#if INTEGRALCOMM_X86_SIMD
+
+#include <immintrin.h>
+
+namespace SevenBitEncoding {
+    namespace detail {
+        namespace {
+            // Septet j of a 7-byte group starts at bit 7 * j, so it lives in the big-endian byte pair
+            // (7 * j / 8, 7 * j / 8 + 1). The masks build those pairs as 16-bit lanes for two groups.
+            constexpr int8_t Z = -1; // pshufb writes zero for indices with the high bit set
+
+            __attribute__((target("ssse3"))) inline __m128i firstGroupPairs() {
+                return _mm_setr_epi8(1, 0, 1, 0, 2, 1, 3, 2, 4, 3, 5, 4, 6, 5, Z, 6);
+            }
+
+            __attribute__((target("ssse3"))) inline __m128i secondGroupPairs() {
+                return _mm_setr_epi8(8, 7, 8, 7, 9, 8, 10, 9, 11, 10, 12, 11, 13, 12, Z, 13);
+            }
+
+            // Shifting lane j left by (7 - 7 * j % 8) % 8 puts the septet in the top 7 bits, so a logical
+            // right shift by 9 extracts it for every lane at once.
+            __attribute__((target("ssse3"))) inline __m128i septetMultipliers() {
+                return _mm_setr_epi16(1, 128, 64, 32, 16, 8, 4, 2);
+            }
+
+            __attribute__((target("ssse3"))) inline __m128i encodeTwoGroups(__m128i bytes) {
+                const __m128i multipliers = septetMultipliers();
+                const __m128i first = _mm_srli_epi16(
+                    _mm_mullo_epi16(_mm_shuffle_epi8(bytes, firstGroupPairs()), multipliers), 9);
+                const __m128i second = _mm_srli_epi16(
+                    _mm_mullo_epi16(_mm_shuffle_epi8(bytes, secondGroupPairs()), multipliers), 9);
+                return _mm_or_si128(_mm_packus_epi16(first, second), _mm_set1_epi8(static_cast<char>(0x80)));
+            }
+
+            // Merges the eight septets of each 64-bit lane into the 56-bit big-endian value they encode:
+            // septet pairs into 14-bit words, word pairs into 28-bit dwords, dword pairs into 56 bits.
+            __attribute__((target("ssse3"))) inline __m128i joinSeptets(__m128i bytes) {
+                const __m128i septets = _mm_and_si128(bytes, _mm_set1_epi8(0x7F));
+                const __m128i words = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(septets, 7), _mm_set1_epi16(0x3F80)),
+                                                   _mm_srli_epi16(septets, 8));
+                const __m128i dwords = _mm_madd_epi16(words, _mm_set1_epi32(0x00014000));
+                return _mm_or_si128(
+                    _mm_and_si128(_mm_slli_epi64(dwords, 28), _mm_set1_epi64x(0x00FFFFFFF0000000LL)),
+                    _mm_srli_epi64(dwords, 32));
+            }
+
+            // Writes the 7 value bytes of each 64-bit lane most significant first, back to back.
+            __attribute__((target("ssse3"))) inline __m128i valueBytes() {
+                return _mm_setr_epi8(6, 5, 4, 3, 2, 1, 0, 14, 13, 12, 11, 10, 9, 8, Z, Z);
+            }
+
+            __attribute__((target("avx2"))) inline __m256i joinSeptets(__m256i bytes) {
+                const __m256i septets = _mm256_and_si256(bytes, _mm256_set1_epi8(0x7F));
+                const __m256i words = _mm256_or_si256(
+                    _mm256_and_si256(_mm256_slli_epi16(septets, 7), _mm256_set1_epi16(0x3F80)),
+                    _mm256_srli_epi16(septets, 8));
+                const __m256i dwords = _mm256_madd_epi16(words, _mm256_set1_epi32(0x00014000));
+                return _mm256_or_si256(
+                    _mm256_and_si256(_mm256_slli_epi64(dwords, 28), _mm256_set1_epi64x(0x00FFFFFFF0000000LL)),
+                    _mm256_srli_epi64(dwords, 32));
+            }
+
+            // Varint decoding in the style of masked VByte: the continuation bits of the next 12 input bytes
+            // select an entry that says how the leading values are laid out. Six values of 1-2 bytes are
+            // shuffled into 16-bit lanes, four values of 1-3 bytes into 32-bit lanes; anything longer is left
+            // to the scalar decoder.
+            constexpr size_t MASK_BITS = 12;
+            constexpr uint8_t SHORT_LAYOUTS = 64; // 2^6 length combinations of six 1-2 byte values
+            constexpr uint8_t LAYOUTS = SHORT_LAYOUTS + 81; // plus 3^4 combinations of four 1-3 byte values
+            constexpr uint8_t NO_LAYOUT = 0xFF;
+
+            struct VarintTables {
+                uint8_t layout[1U << MASK_BITS];
+                uint8_t consumed[1U << MASK_BITS];
+                int8_t shuffle[LAYOUTS][16];
+            };
+
+            constexpr VarintTables buildVarintTables() {
+                VarintTables tables{};
+                for (size_t mask = 0; mask < (1U << MASK_BITS); mask++) {
+                    size_t lengths[6] = {};
+                    size_t values = 0;
+                    size_t position = 0;
+                    while (values < 6) {
+                        size_t end = position;
+                        while (end < MASK_BITS && ((mask >> end) & 1U) != 0) {
+                            end++;
+                        }
+                        if (end == MASK_BITS) {
+                            break; // terminator not among the bytes covered by the mask
+                        }
+                        lengths[values++] = end + 1 - position;
+                        position = end + 1;
+                    }
+
+                    tables.layout[mask] = NO_LAYOUT;
+                    uint8_t shortLayout = 0;
+                    size_t shortBytes = 0;
+                    bool isShort = values == 6;
+                    for (size_t i = 0; i < 6 && isShort; i++) {
+                        isShort = lengths[i] <= 2;
+                        shortLayout |= static_cast<uint8_t>((lengths[i] - 1) << i);
+                        shortBytes += lengths[i];
+                    }
+                    if (isShort) {
+                        tables.layout[mask] = shortLayout;
+                        tables.consumed[mask] = static_cast<uint8_t>(shortBytes);
+                        continue;
+                    }
+
+                    uint8_t longLayout = 0;
+                    size_t longBytes = 0;
+                    bool isLong = values >= 4;
+                    for (size_t i = 4; i-- > 0 && isLong;) {
+                        isLong = lengths[i] <= 3;
+                        longLayout = static_cast<uint8_t>(longLayout * 3 + (lengths[i] - 1));
+                        longBytes += lengths[i];
+                    }
+                    if (isLong) {
+                        tables.layout[mask] = static_cast<uint8_t>(SHORT_LAYOUTS + longLayout);
+                        tables.consumed[mask] = static_cast<uint8_t>(longBytes);
+                    }
+                }
+
+                for (size_t layout = 0; layout < LAYOUTS; layout++) {
+                    const bool isShort = layout < SHORT_LAYOUTS;
+                    const size_t laneSize = isShort ? 2 : 4;
+                    const size_t lanes = isShort ? 6 : 4;
+                    size_t digits = layout - SHORT_LAYOUTS;
+                    size_t position = 0;
+                    for (size_t i = 0; i < 16; i++) {
+                        tables.shuffle[layout][i] = -1;
+                    }
+                    for (size_t lane = 0; lane < lanes; lane++) {
+                        size_t length = 0;
+                        if (isShort) {
+                            length = ((layout >> lane) & 1U) + 1;
+                        } else {
+                            length = (digits % 3) + 1;
+                            digits /= 3;
+                        }
+                        for (size_t i = 0; i < length; i++) {
+                            tables.shuffle[layout][(lane * laneSize) + i] = static_cast<int8_t>(position++);
+                        }
+                    }
+                }
+                return tables;
+            }
+
+            constexpr VarintTables VARINT_TABLES = buildVarintTables();
+
+            __attribute__((target("ssse3"))) inline void storeValues(uint32_t* values, __m128i lanes) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(values), lanes);
+            }
+
+            __attribute__((target("ssse3"))) inline void storeValues(uint64_t* values, __m128i lanes) {
+                const __m128i zero = _mm_setzero_si128();
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(values), _mm_unpacklo_epi32(lanes, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(values + 2), _mm_unpackhi_epi32(lanes, zero));
+            }
+
+            template <typename T>
+            __attribute__((target("ssse3"))) size_t decodeShortValues(const uint8_t* input, size_t inputSize,
+                                                                      T* values, size_t count,
+                                                                      size_t& consumedBytes) {
+                const __m128i zero = _mm_setzero_si128();
+                size_t position = 0;
+                size_t decoded = 0;
+
+                while (inputSize - position >= 16 && count - decoded >= 16) {
+                    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + position));
+                    const auto continuation = static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+                    if (continuation == 0) {
+                        // Sixteen single-byte values
+                        const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+                        const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+                        storeValues(values + decoded, _mm_unpacklo_epi16(low, zero));
+                        storeValues(values + decoded + 4, _mm_unpackhi_epi16(low, zero));
+                        storeValues(values + decoded + 8, _mm_unpacklo_epi16(high, zero));
+                        storeValues(values + decoded + 12, _mm_unpackhi_epi16(high, zero));
+                        position += 16;
+                        decoded += 16;
+                        continue;
+                    }
+
+                    const uint32_t mask = continuation & ((1U << MASK_BITS) - 1);
+                    const uint8_t layout = VARINT_TABLES.layout[mask];
+                    if (layout == NO_LAYOUT) {
+                        break;
+                    }
+
+                    const __m128i lanes = _mm_shuffle_epi8(
+                        bytes, _mm_loadu_si128(reinterpret_cast<const __m128i*>(VARINT_TABLES.shuffle[layout])));
+                    if (layout < SHORT_LAYOUTS) {
+                        const __m128i words =
+                            _mm_or_si128(_mm_and_si128(lanes, _mm_set1_epi16(0x007F)),
+                                         _mm_srli_epi16(_mm_and_si128(lanes, _mm_set1_epi16(0x7F00)), 1));
+                        storeValues(values + decoded, _mm_unpacklo_epi16(words, zero));
+                        storeValues(values + decoded + 4, _mm_unpackhi_epi16(words, zero));
+                        decoded += 6;
+                    } else {
+                        const __m128i dwords = _mm_or_si128(
+                            _mm_or_si128(_mm_and_si128(lanes, _mm_set1_epi32(0x7F)),
+                                         _mm_srli_epi32(_mm_and_si128(lanes, _mm_set1_epi32(0x7F00)), 1)),
+                            _mm_srli_epi32(_mm_and_si128(lanes, _mm_set1_epi32(0x7F0000)), 2));
+                        storeValues(values + decoded, dwords);
+                        decoded += 4;
+                    }
+                    position += VARINT_TABLES.consumed[mask];
+                }
+
+                consumedBytes = position;
+                return decoded;
+            }
+        } // namespace
+
+        bool cpuSupportsSsse3() {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("ssse3") != 0;
+        }
+
+        bool cpuSupportsAvx2() {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") != 0;
+        }
+
+        __attribute__((target("ssse3"))) void encodeBlocksSsse3(const uint8_t* input, size_t blocks,
+                                                                 uint8_t* output) {
+            for (size_t block = 0; block < blocks; block++) {
+                for (size_t i = 0; i < 4; i++) {
+                    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + (i * 14)));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + (i * 16)), encodeTwoGroups(bytes));
+                }
+                input += DECODED_BLOCK_SIZE;
+                output += ENCODED_BLOCK_SIZE;
+            }
+        }
+
+        __attribute__((target("avx2"))) void encodeBlocksAvx2(const uint8_t* input, size_t blocks, uint8_t* output) {
+            const __m256i firstPairs = _mm256_broadcastsi128_si256(firstGroupPairs());
+            const __m256i secondPairs = _mm256_broadcastsi128_si256(secondGroupPairs());
+            const __m256i multipliers = _mm256_broadcastsi128_si256(septetMultipliers());
+            const __m256i continuation = _mm256_set1_epi8(static_cast<char>(0x80));
+
+            for (size_t block = 0; block < blocks; block++) {
+                for (size_t i = 0; i < 2; i++) {
+                    // Each 128-bit lane holds two groups; packus keeps the lanes apart, so the four groups
+                    // come out in input order.
+                    const uint8_t* in = input + (i * 28);
+                    const __m256i bytes = _mm256_inserti128_si256(
+                        _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in))),
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 14)), 1);
+                    const __m256i first =
+                        _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_shuffle_epi8(bytes, firstPairs), multipliers), 9);
+                    const __m256i second =
+                        _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_shuffle_epi8(bytes, secondPairs), multipliers), 9);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + (i * 32)),
+                                        _mm256_or_si256(_mm256_packus_epi16(first, second), continuation));
+                }
+                input += DECODED_BLOCK_SIZE;
+                output += ENCODED_BLOCK_SIZE;
+            }
+        }
+
+        __attribute__((target("ssse3"))) bool decodeBlocksSsse3(const uint8_t* input, size_t blocks,
+                                                                 uint8_t* output) {
+            const __m128i order = valueBytes();
+            bool continuation = true;
+
+            for (size_t block = 0; block < blocks; block++) {
+                __m128i msbs = _mm_set1_epi8(static_cast<char>(0xFF));
+                for (size_t i = 0; i < 4; i++) {
+                    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + (i * 16)));
+                    msbs = _mm_and_si128(msbs, bytes);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + (i * 14)),
+                                     _mm_shuffle_epi8(joinSeptets(bytes), order));
+                }
+                continuation = continuation && _mm_movemask_epi8(msbs) == 0xFFFF;
+                input += ENCODED_BLOCK_SIZE;
+                output += DECODED_BLOCK_SIZE;
+            }
+            return continuation;
+        }
+
+        __attribute__((target("avx2"))) bool decodeBlocksAvx2(const uint8_t* input, size_t blocks, uint8_t* output) {
+            const __m256i order = _mm256_broadcastsi128_si256(valueBytes());
+            bool continuation = true;
+
+            for (size_t block = 0; block < blocks; block++) {
+                __m256i msbs = _mm256_set1_epi8(static_cast<char>(0xFF));
+                for (size_t i = 0; i < 2; i++) {
+                    const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + (i * 32)));
+                    msbs = _mm256_and_si256(msbs, bytes);
+                    // Each lane yields 14 bytes; the second store overwrites the two padding bytes of the first
+                    const __m256i values = _mm256_shuffle_epi8(joinSeptets(bytes), order);
+                    uint8_t* out = output + (i * 28);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(values));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 14), _mm256_extracti128_si256(values, 1));
+                }
+                continuation = continuation && _mm256_movemask_epi8(msbs) == -1;
+                input += ENCODED_BLOCK_SIZE;
+                output += DECODED_BLOCK_SIZE;
+            }
+            return continuation;
+        }
+
+        // movemask collects the MSBs, so the terminator is the lowest zero bit of the mask
+        __attribute__((target("sse2"))) size_t findLastByteSse2(const uint8_t* buffer, size_t length) {
+            size_t i = 0;
+            for (; i + 16 <= length; i += 16) {
+                const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + i));
+                const auto terminators = static_cast<uint32_t>(~_mm_movemask_epi8(bytes)) & 0xFFFFU;
+                if (terminators != 0) {
+                    return i + static_cast<size_t>(__builtin_ctz(terminators));
+                }
+            }
+            for (; i < length; i++) {
+                if ((buffer[i] & 0x80) == 0) {
+                    return i;
+                }
+            }
+            return length;
+        }
+
+        __attribute__((target("avx2"))) size_t findLastByteAvx2(const uint8_t* buffer, size_t length) {
+            size_t i = 0;
+            for (; i + 32 <= length; i += 32) {
+                const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer + i));
+                const auto terminators = ~static_cast<uint32_t>(_mm256_movemask_epi8(bytes));
+                if (terminators != 0) {
+                    return i + static_cast<size_t>(__builtin_ctz(terminators));
+                }
+            }
+            return i + findLastByteSse2(buffer + i, length - i);
+        }
+
+        size_t decodeValuesSsse3(const uint8_t* input, size_t inputSize, uint32_t* values, size_t count,
+                                 size_t& consumedBytes) {
+            return decodeShortValues(input, inputSize, values, count, consumedBytes);
+        }
+
+        size_t decodeValuesSsse3(const uint8_t* input, size_t inputSize, uint64_t* values, size_t count,
+                                 size_t& consumedBytes) {
+            return decodeShortValues(input, inputSize, values, count, consumedBytes);
+        }
+    } // namespace detail
+} // namespace SevenBitEncoding
+
+#endif
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if !defined(INTEGRALCOMM_NO_SIMD) && (defined(__x86_64__) || defined(__i386__)) &&                                   \
+    (defined(__GNUC__) || defined(__clang__))
+#define INTEGRALCOMM_X86_SIMD 1
+#else
+#define INTEGRALCOMM_X86_SIMD 0
+#endif
+
+namespace SevenBitEncoding {
+    namespace detail {
+        // 56 input bytes are exactly 8 groups of 7 bytes, which encode to 64 bytes with no carry left over.
+        inline constexpr size_t DECODED_BLOCK_SIZE = 56;
+        inline constexpr size_t ENCODED_BLOCK_SIZE = 64;
+        // The 16-byte loads of the encode kernels read up to this many bytes past the last block.
+        inline constexpr size_t ENCODE_READ_SLACK = 2;
+        // The 16-byte stores of the decode kernels write up to this many bytes past the last block.
+        inline constexpr size_t DECODE_WRITE_SLACK = 2;
+
+        using EncodeBlocksFn = void (*)(const uint8_t* input, size_t blocks, uint8_t* output);
+        // Returns false if any input byte of the blocks is missing its continuation bit.
+        using DecodeBlocksFn = bool (*)(const uint8_t* input, size_t blocks, uint8_t* output);
+        using FindLastByteFn = size_t (*)(const uint8_t* buffer, size_t length);
+        // Decodes leading varints of up to 3 bytes while 16 input bytes and 16 output slots are left. Returns
+        // the number of values written and stops at the first value it cannot take.
+        using DecodeValuesFn = size_t (*)(const uint8_t* input, size_t inputSize, uint32_t* values, size_t count,
+                                          size_t& consumedBytes);
+        using DecodeValues64Fn = size_t (*)(const uint8_t* input, size_t inputSize, uint64_t* values, size_t count,
+                                            size_t& consumedBytes);
+
+#if INTEGRALCOMM_X86_SIMD
+        bool cpuSupportsSsse3();
+        bool cpuSupportsAvx2();
+
+        void encodeBlocksSsse3(const uint8_t* input, size_t blocks, uint8_t* output);
+        void encodeBlocksAvx2(const uint8_t* input, size_t blocks, uint8_t* output);
+        bool decodeBlocksSsse3(const uint8_t* input, size_t blocks, uint8_t* output);
+        bool decodeBlocksAvx2(const uint8_t* input, size_t blocks, uint8_t* output);
+        size_t findLastByteSse2(const uint8_t* buffer, size_t length);
+        size_t findLastByteAvx2(const uint8_t* buffer, size_t length);
+        size_t decodeValuesSsse3(const uint8_t* input, size_t inputSize, uint32_t* values, size_t count,
+                                 size_t& consumedBytes);
+        size_t decodeValuesSsse3(const uint8_t* input, size_t inputSize, uint64_t* values, size_t count,
+                                 size_t& consumedBytes);
+#endif
+    } // namespace detail
+} // namespace SevenBitEncoding
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Processes a 7-byte group as one 64-bit word instead of byte by byte. Define INTEGRALCOMM_SWAR=0 to keep
+// the byte loops only. BMI2 is used when the compiler targets it (-mbmi2, -march=haswell, ...).
+#ifndef INTEGRALCOMM_SWAR
+#define INTEGRALCOMM_SWAR 1
+#endif
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+// Unaligned 8-byte loads read bytes in address order from the least significant end
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define INTEGRALCOMM_WORD_LOADS 1
+#else
+#define INTEGRALCOMM_WORD_LOADS 0
+#endif
+
+namespace SevenBitEncoding {
+    namespace detail {
+        inline constexpr size_t GROUP_SIZE = 7;
+        inline constexpr size_t ENCODED_GROUP_SIZE = 8;
+
+        // Moves the eight 7-bit fields of a 56-bit value into the low 7 bits of each byte
+        inline uint64_t spreadSeptets(uint64_t value) {
+#if defined(__BMI2__)
+            return _pdep_u64(value, 0x7F7F7F7F7F7F7F7FULL);
+#else
+            value = (value & 0x000000000FFFFFFFULL) | ((value & 0x00FFFFFFF0000000ULL) << 4);
+            value = (value & 0x00003FFF00003FFFULL) | ((value & 0x0FFFC0000FFFC000ULL) << 2);
+            return (value & 0x007F007F007F007FULL) | ((value & 0x3F803F803F803F80ULL) << 1);
+#endif
+        }
+
+        // Inverse of spreadSeptets: packs the low 7 bits of each byte into a 56-bit value
+        inline uint64_t gatherSeptets(uint64_t word) {
+#if defined(__BMI2__)
+            return _pext_u64(word, 0x7F7F7F7F7F7F7F7FULL);
+#else
+            word &= 0x7F7F7F7F7F7F7F7FULL;
+            word = (word & 0x007F007F007F007FULL) | ((word & 0x7F007F007F007F00ULL) >> 1);
+            word = (word & 0x00003FFF00003FFFULL) | ((word & 0x3FFF00003FFF0000ULL) >> 2);
+            return (word & 0x000000000FFFFFFFULL) | ((word & 0x0FFFFFFF00000000ULL) >> 4);
+#endif
+        }
+
+        // Encodes 7 input bytes into 8 output bytes, all with the continuation bit set
+        inline void encodeGroup(const uint8_t* input, uint8_t* output) {
+            uint64_t value = 0;
+            for (size_t i = 0; i < GROUP_SIZE; i++) {
+                value = (value << 8) | input[i];
+            }
+            const uint64_t septets = spreadSeptets(value);
+            for (size_t i = 0; i < ENCODED_GROUP_SIZE; i++) {
+                output[i] = static_cast<uint8_t>(septets >> (8 * (ENCODED_GROUP_SIZE - 1 - i))) | 0x80;
+            }
+        }
+
+        // Decodes 8 encoded bytes into 7 output bytes. The input is read completely before writing, so
+        // output may point at input.
+        inline void decodeGroup(const uint8_t* input, uint8_t* output) {
+            uint64_t word = 0;
+            for (size_t i = 0; i < ENCODED_GROUP_SIZE; i++) {
+                word = (word << 8) | input[i];
+            }
+            const uint64_t value = gatherSeptets(word);
+            for (size_t i = 0; i < GROUP_SIZE; i++) {
+                output[i] = static_cast<uint8_t>(value >> (8 * (GROUP_SIZE - 1 - i)));
+            }
+        }
+
+        // Index of the first byte with the MSB clear, or length if there is none
+        inline size_t findLastByteWords(const uint8_t* buffer, size_t length) {
+            size_t i = 0;
+#if INTEGRALCOMM_WORD_LOADS
+            for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+                uint64_t word = 0;
+                std::memcpy(&word, buffer + i, sizeof(word));
+                const uint64_t terminators = ~word & 0x8080808080808080ULL;
+                if (terminators != 0) {
+                    return i + static_cast<size_t>(__builtin_ctzll(terminators) / 8);
+                }
+            }
+#endif
+            for (; i < length; i++) {
+                if ((buffer[i] & 0x80) == 0) {
+                    return i;
+                }
+            }
+            return length;
+        }
+
+#if INTEGRALCOMM_WORD_LOADS
+        // decodeValue for input with at least 8 readable bytes: the first clear MSB, or the fifth byte, ends the
+        // value, and gatherSeptets joins the septets of the bytes before it.
+        inline uint32_t decodeValueWord(const uint8_t* input, size_t& consumedBytes) {
+            uint64_t word = 0;
+            std::memcpy(&word, input, sizeof(word));
+            const uint64_t stops = (~word & 0x8080808080808080ULL) | 0x0000008000000000ULL;
+            const size_t length = static_cast<size_t>(__builtin_ctzll(stops) / 8) + 1;
+            consumedBytes = length;
+            return static_cast<uint32_t>(gatherSeptets(word & ((1ULL << (length * 8)) - 1)));
+        }
+#endif
+    } // namespace detail
+} // namespace SevenBitEncoding
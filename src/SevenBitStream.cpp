@@ -0,0 +1,124 @@
+#include "IntegralCommunication/SevenBitStream.h"
+#include "IntegralCommunication/SevenBitEncoding.h"
+
+#include <algorithm>
+
+namespace {
+    using SevenBitEncoding::ENCODING_SIZE;
+    using SevenBitEncoding::FIRST_BIT;
+    using SevenBitEncoding::LAST_SEVEN_BITS;
+    constexpr size_t GROUP_SIZE = 7;
+    constexpr size_t ENCODED_GROUP_SIZE = 8;
+} // namespace
+
+size_t SevenBitEncoder::getEncodedChunkSize(size_t inputLength) {
+    // Every byte completes one septet, plus one more each time the carry reaches 7 bits
+    return inputLength + ((inputLength + GROUP_SIZE - 1) / GROUP_SIZE);
+}
+
+size_t SevenBitEncoder::encode(const uint8_t* input, size_t inputLength, uint8_t* output) {
+    size_t outIndex = 0;
+
+    // Group-aligned runs go through the buffer codec; its last byte becomes the held-back septet. A septet held
+    // back from the previous call is written first, so the run would then end one byte past
+    // getEncodedChunkSize(); its last group goes through emit() below instead.
+    size_t aligned = 0;
+    if (_carryBits == 0 && inputLength >= GROUP_SIZE) {
+        aligned = inputLength - (inputLength % GROUP_SIZE) - (_hasPending ? GROUP_SIZE : 0);
+    }
+    if (aligned > 0) {
+        if (_hasPending) {
+            output[outIndex++] = _pending | FIRST_BIT;
+        }
+        outIndex += SevenBitEncoding::encodeBuffer(input, aligned, output + outIndex);
+        _pending = output[--outIndex];
+        _hasPending = true;
+        input += aligned;
+        inputLength -= aligned;
+    }
+
+    for (size_t i = 0; i < inputLength; i++) {
+        const uint8_t current = input[i];
+        emit(_carry | (current >> (_carryBits + 1)), output, outIndex);
+        _carryBits++;
+        _carry = (current & SevenBitEncoding::leftMask(_carryBits)) << (ENCODING_SIZE - _carryBits);
+        if (_carryBits == ENCODING_SIZE) {
+            emit(_carry, output, outIndex);
+            _carry = 0;
+            _carryBits = 0;
+        }
+    }
+    return outIndex;
+}
+
+size_t SevenBitEncoder::finish(uint8_t* output) {
+    size_t outIndex = 0;
+    if (_carryBits != 0) {
+        emit(_carry, output, outIndex);
+    }
+    if (_hasPending) {
+        output[outIndex++] = _pending & LAST_SEVEN_BITS;
+    }
+    reset();
+    return outIndex;
+}
+
+void SevenBitEncoder::reset() {
+    _pending = 0;
+    _hasPending = false;
+    _carry = 0;
+    _carryBits = 0;
+}
+
+void SevenBitEncoder::emit(uint8_t septet, uint8_t* output, size_t& outIndex) {
+    if (_hasPending) {
+        output[outIndex++] = _pending | FIRST_BIT;
+    }
+    _pending = septet;
+    _hasPending = true;
+}
+
+SevenBitDecoder::Status SevenBitDecoder::decode(const uint8_t* input, size_t inputLength, size_t& consumed,
+                                                uint8_t* output, size_t outputLength, size_t& produced) {
+    consumed = 0;
+    produced = 0;
+
+    while (consumed < inputLength) {
+        // At a group boundary, whole groups before the next terminator go through the buffer codec
+        if (_bitCount == 0) {
+            const size_t run = SevenBitEncoding::findLastByte(input + consumed, inputLength - consumed);
+            const size_t groups = std::min(run / ENCODED_GROUP_SIZE, (outputLength - produced) / GROUP_SIZE);
+            if (groups > 0) {
+                produced += SevenBitEncoding::decodeBuffer(input + consumed, groups * ENCODED_GROUP_SIZE,
+                                                           output + produced, groups * GROUP_SIZE);
+                consumed += groups * ENCODED_GROUP_SIZE;
+                continue;
+            }
+        }
+
+        // A byte yields output whenever bits are left over from the previous one
+        if (_bitCount > 0 && produced == outputLength) {
+            return Status::OutputFull;
+        }
+
+        const uint8_t byte = input[consumed++];
+        _bits = static_cast<uint16_t>((_bits << ENCODING_SIZE) | (byte & LAST_SEVEN_BITS));
+        _bitCount += ENCODING_SIZE;
+        if (_bitCount >= 8) {
+            _bitCount -= 8;
+            output[produced++] = static_cast<uint8_t>(_bits >> _bitCount);
+            _bits &= static_cast<uint16_t>((1U << _bitCount) - 1);
+        }
+
+        if (SevenBitEncoding::isLastByte(byte)) {
+            reset(); // the remaining bits are padding
+            return Status::FrameComplete;
+        }
+    }
+    return Status::NeedInput;
+}
+
+void SevenBitDecoder::reset() {
+    _bits = 0;
+    _bitCount = 0;
+}
@@ -0,0 +1,171 @@
+#include "IntegralCommunication/AsyncBufferedCommunication.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Records each started write; the test decides when it completes
+    template <size_t BufferCount>
+    class ManualAsyncCommunication : public AsyncBufferedCommunication<BufferCount, LocalCounterStats> {
+      public:
+        using AsyncBufferedCommunication<BufferCount, LocalCounterStats>::AsyncBufferedCommunication;
+
+        std::vector<std::vector<uint8_t>> started;
+
+      private:
+        void startWriteImpl(const uint8_t* data, size_t size) override {
+            started.emplace_back(data, data + size);
+        }
+
+        size_t availableImpl() override {
+            return 0;
+        }
+        size_t readImpl(uint8_t*, size_t) override {
+            return 0;
+        }
+    };
+
+    // Sends from a worker thread, like a DMA channel raising its completion interrupt
+    class ThreadedAsyncCommunication : public AsyncBufferedCommunication<3> {
+      public:
+        ThreadedAsyncCommunication(uint8_t* buffers, size_t bufferSize)
+            : AsyncBufferedCommunication(buffers, bufferSize), _worker([this] { run(); }) {}
+
+        ~ThreadedAsyncCommunication() override {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stopping = true;
+            }
+            _wake.notify_one();
+            _worker.join();
+        }
+
+        std::vector<uint8_t> sink;
+        std::atomic<size_t> overlapping{0};
+
+      private:
+        void startWriteImpl(const uint8_t* data, size_t size) override {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (_data != nullptr) {
+                    overlapping++;
+                }
+                _data = data;
+                _size = size;
+            }
+            _wake.notify_one();
+        }
+
+        size_t availableImpl() override {
+            return 0;
+        }
+        size_t readImpl(uint8_t*, size_t) override {
+            return 0;
+        }
+
+        void run() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            for (;;) {
+                _wake.wait(lock, [this] { return _stopping || _data != nullptr; });
+                if (_data == nullptr) {
+                    return;
+                }
+                sink.insert(sink.end(), _data, _data + _size);
+                _data = nullptr;
+
+                lock.unlock();
+                std::this_thread::yield(); // the producer keeps filling meanwhile
+                completeWrite();
+                lock.lock();
+            }
+        }
+
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        const uint8_t* _data = nullptr;
+        size_t _size = 0;
+        bool _stopping = false;
+        std::thread _worker;
+    };
+} // namespace
+
+TEST(AsyncBufferedCommunicationTests, FillsNextBufferWhileOneIsInFlight) {
+    uint8_t buffers[2 * 4] = {};
+    ManualAsyncCommunication<2> comm(buffers, 4);
+
+    const uint8_t first[] = {1, 2, 3, 4, 5, 6};
+    comm.write(first, sizeof(first));
+    ASSERT_EQ(comm.started.size(), 1u);
+    EXPECT_EQ(comm.started[0], (std::vector<uint8_t>{1, 2, 3, 4}));
+    EXPECT_EQ(comm.freeBuffers(), 1u);
+
+    // The second buffer fills up and queues behind the one in flight; nothing is left for byte 9
+    const uint8_t second[] = {7, 8, 9};
+    comm.write(second, sizeof(second));
+    EXPECT_EQ(comm.started.size(), 1u);
+    EXPECT_EQ(comm.freeBuffers(), 0u);
+    EXPECT_EQ(comm.stats().txOverflowBytes(), 1u);
+
+    comm.completeWrite();
+    ASSERT_EQ(comm.started.size(), 2u);
+    EXPECT_EQ(comm.started[1], (std::vector<uint8_t>{5, 6, 7, 8}));
+    EXPECT_EQ(comm.freeBuffers(), 1u);
+
+    const uint8_t third[] = {10};
+    comm.write(third, sizeof(third));
+    comm.flush();
+    EXPECT_EQ(comm.started.size(), 2u);
+
+    comm.completeWrite();
+    ASSERT_EQ(comm.started.size(), 3u);
+    EXPECT_EQ(comm.started[2], (std::vector<uint8_t>{10}));
+    EXPECT_FALSE(comm.idle());
+
+    comm.completeWrite();
+    EXPECT_TRUE(comm.idle());
+    EXPECT_EQ(comm.stats().bytesWritten(), 9u);
+}
+
+TEST(AsyncBufferedCommunicationTests, FlushWithNothingBufferedStartsNothing) {
+    uint8_t buffers[2 * 4] = {};
+    ManualAsyncCommunication<2> comm(buffers, 4);
+
+    comm.flush();
+    EXPECT_TRUE(comm.started.empty());
+    EXPECT_TRUE(comm.idle());
+}
+
+TEST(AsyncBufferedCommunicationTests, KeepsOrderWithThreadedTransport) {
+    std::vector<uint8_t> data(20000);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    std::vector<uint8_t> buffers(3 * 64);
+    {
+        ThreadedAsyncCommunication comm(buffers.data(), 64);
+
+        size_t offset = 0;
+        while (offset < data.size()) {
+            const size_t chunk = std::min({data.size() - offset, size_t{50}, comm.freeSpace()});
+            if (chunk == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            comm.write(data.data() + offset, chunk);
+            offset += chunk;
+        }
+        comm.flush();
+        while (!comm.idle()) {
+            std::this_thread::yield();
+        }
+
+        EXPECT_EQ(comm.sink, data);
+        EXPECT_EQ(comm.overlapping.load(), 0u);
+    }
+}
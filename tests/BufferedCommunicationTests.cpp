@@ -1,3 +1,6 @@
+// Existing code forward declares the class; this fails to compile if it turns into an alias
+class BufferedCommunication;
+
 #include "IntegralCommunication/BufferedCommunication.h"
 #include <algorithm>
 #include <cstdint>
@@ -110,3 +113,262 @@ TEST(BufferedCommunicationTests, FlushHandlesPartialWritesCorrectly) {
     }
     EXPECT_EQ(comm.bufferIndex(), 0u);
 }
+
+struct BufferedCommunicationLayout {
+    void* vtable;
+    uint8_t* buffer;
+    size_t bufferSize;
+    size_t bufferIndex;
+    size_t bufferHead;
+    bool ring;
+    bool writeThrough;
+    uint8_t* readBuffer;
+    size_t readBufferSize;
+    size_t readHead;
+    size_t readLength;
+};
+
+static_assert(sizeof(BufferedCommunication) == sizeof(BufferedCommunicationLayout),
+              "NoStats adds nothing to the object");
+
+class CountingBufferedCommunication : public BasicBufferedCommunication<LocalCounterStats> {
+  public:
+    CountingBufferedCommunication(uint8_t* buffer, size_t bufferSize, size_t capacity)
+        : BasicBufferedCommunication(buffer, bufferSize), _capacity(capacity) {}
+
+  private:
+    // Takes at most 3 bytes per call and nothing once capacity bytes went out
+    size_t writeImpl(const uint8_t*, size_t size) override {
+        const size_t toWrite = std::min({size, size_t{3}, _capacity});
+        _capacity -= toWrite;
+        return toWrite;
+    }
+
+    size_t availableImpl() override {
+        return 0;
+    }
+    size_t readImpl(uint8_t*, size_t) override {
+        return 0;
+    }
+
+    size_t _capacity;
+};
+
+TEST(BufferedCommunicationTests, CounterStatsTrackPartialWritesAndOverflow) {
+    uint8_t buffer[4] = {};
+    CountingBufferedCommunication comm(buffer, sizeof(buffer), 5);
+
+    const uint8_t data[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    comm.write(data, sizeof(data));
+
+    // Bytes 1-4 go out as 3 + 1 and byte 5 alone before the transport stalls; the two flushes that then write
+    // nothing count as partial too. Byte 9 stays buffered and byte 10 is discarded.
+    EXPECT_EQ(comm.stats().bytesWritten(), 5u);
+    EXPECT_EQ(comm.stats().partialWrites(), 4u);
+    EXPECT_EQ(comm.stats().txOverflowBytes(), 1u);
+}
+
+// Takes at most 3 bytes per call out of a budget the test hands out
+class StallingBufferedCommunication : public BufferedCommunication {
+  public:
+    using BufferedCommunication::bufferHead;
+    using BufferedCommunication::bufferIndex;
+
+    StallingBufferedCommunication(uint8_t* buffer, size_t bufferSize, size_t budget)
+        : BufferedCommunication(buffer, bufferSize), _budget(budget) {}
+
+    void allow(size_t bytes) {
+        _budget += bytes;
+    }
+
+    const std::vector<uint8_t>& sink() const {
+        return _sink;
+    }
+
+  private:
+    size_t writeImpl(const uint8_t* data, size_t size) override {
+        const size_t toWrite = std::min({size, size_t{3}, _budget});
+        _sink.insert(_sink.end(), data, data + toWrite);
+        _budget -= toWrite;
+        return toWrite;
+    }
+
+    size_t availableImpl() override {
+        return 0;
+    }
+    size_t readImpl(uint8_t*, size_t) override {
+        return 0;
+    }
+
+    std::vector<uint8_t> _sink;
+    size_t _budget;
+};
+
+TEST(BufferedCommunicationTests, RingModeWrapsAroundAfterPartialFlush) {
+    uint8_t buffer[8] = {};
+    StallingBufferedCommunication comm(buffer, sizeof(buffer), 4);
+    ASSERT_TRUE(comm.setRingBuffer(true));
+
+    const uint8_t first[] = {1, 2, 3, 4, 5, 6};
+    comm.write(first, sizeof(first));
+    comm.flush();
+    EXPECT_EQ(comm.bufferHead(), 4u);
+    EXPECT_EQ(comm.bufferIndex(), 2u);
+
+    // Bytes 5 and 6 stay where they are; 7 and 8 fill the end and the rest wraps to the front
+    const uint8_t second[] = {7, 8, 9, 10, 11, 12};
+    comm.write(second, sizeof(second));
+    EXPECT_EQ(comm.bufferIndex(), 8u);
+    EXPECT_EQ(buffer[4], 5);
+    EXPECT_EQ(buffer[7], 8);
+    EXPECT_EQ(buffer[0], 9);
+    EXPECT_EQ(buffer[3], 12);
+
+    comm.allow(SIZE_MAX / 2);
+    comm.flush();
+    EXPECT_EQ(comm.bufferIndex(), 0u);
+    EXPECT_EQ(comm.bufferHead(), 0u);
+
+    const std::vector<uint8_t> expected = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    EXPECT_EQ(comm.sink(), expected);
+}
+
+TEST(BufferedCommunicationTests, RingModeOnlySwitchesWhenEmpty) {
+    uint8_t buffer[4] = {};
+    StallingBufferedCommunication comm(buffer, sizeof(buffer), 0);
+
+    const uint8_t data[] = {1};
+    comm.write(data, sizeof(data));
+    EXPECT_FALSE(comm.setRingBuffer(true));
+
+    comm.allow(1);
+    comm.flush();
+    EXPECT_TRUE(comm.setRingBuffer(true));
+}
+
+TEST(BufferedCommunicationTests, WriteThroughFlushesPendingThenSkipsTheBuffer) {
+    uint8_t buffer[4] = {};
+    TestBufferedCommunication comm(buffer, sizeof(buffer));
+    comm.setWriteThrough(true);
+
+    const uint8_t small[] = {1, 2};
+    comm.write(small, sizeof(small));
+    EXPECT_TRUE(comm.sink().empty());
+
+    const uint8_t large[] = {3, 4, 5, 6, 7, 8};
+    comm.write(large, sizeof(large));
+    EXPECT_EQ(comm.bufferIndex(), 0u);
+    const std::vector<uint8_t> expected = {1, 2, 3, 4, 5, 6, 7, 8};
+    EXPECT_EQ(comm.sink(), expected);
+}
+
+TEST(BufferedCommunicationTests, WriteThroughBuffersWhatTheTransportLeaves) {
+    uint8_t buffer[4] = {};
+    StallingBufferedCommunication comm(buffer, sizeof(buffer), 5);
+    comm.setWriteThrough(true);
+
+    const uint8_t data[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    comm.write(data, sizeof(data));
+
+    // 3 + 2 bytes go straight out, the last 3 fit in the buffer
+    EXPECT_EQ(comm.sink().size(), 5u);
+    EXPECT_EQ(comm.bufferIndex(), 3u);
+    EXPECT_EQ(buffer[0], 6);
+    EXPECT_EQ(buffer[2], 8);
+}
+
+// Serves bytes 0, 1, 2, ... and counts the calls that would be syscalls on a real transport
+class ReadAheadBufferedCommunication : public BufferedCommunication {
+  public:
+    ReadAheadBufferedCommunication(uint8_t* readBuffer, size_t readBufferSize, size_t streamSize)
+        : BufferedCommunication(nullptr, 0, readBuffer, readBufferSize), _streamSize(streamSize) {}
+
+    size_t readCalls = 0;
+    size_t availableCalls = 0;
+    size_t lastReadSize = 0;
+
+  private:
+    size_t writeImpl(const uint8_t*, size_t) override {
+        return 0;
+    }
+
+    size_t availableImpl() override {
+        availableCalls++;
+        return _streamSize - _position;
+    }
+
+    size_t readImpl(uint8_t* data, size_t size) override {
+        readCalls++;
+        lastReadSize = size;
+        const size_t toRead = std::min(size, _streamSize - _position);
+        for (size_t i = 0; i < toRead; i++) {
+            data[i] = static_cast<uint8_t>(_position++);
+        }
+        return toRead;
+    }
+
+    size_t _streamSize;
+    size_t _position = 0;
+};
+
+TEST(BufferedCommunicationTests, ReadAheadServesSmallReadsFromMemory) {
+    uint8_t readBuffer[32] = {};
+    ReadAheadBufferedCommunication comm(readBuffer, sizeof(readBuffer), 100);
+
+    uint8_t out[4] = {};
+    for (size_t i = 0; i < 8; i++) {
+        ASSERT_EQ(comm.read(out, sizeof(out)), sizeof(out));
+        EXPECT_EQ(out[0], i * 4);
+        EXPECT_EQ(out[3], i * 4 + 3);
+    }
+    EXPECT_EQ(comm.readCalls, 1u);
+    EXPECT_EQ(comm.lastReadSize, sizeof(readBuffer));
+
+    // Empty again, so the next byte needs the transport
+    EXPECT_EQ(comm.available(), 68u);
+    EXPECT_EQ(comm.availableCalls, 1u);
+    ASSERT_EQ(comm.read(out, 1), 1u);
+    EXPECT_EQ(comm.available(), 31u);
+    EXPECT_EQ(comm.availableCalls, 1u);
+}
+
+TEST(BufferedCommunicationTests, LargeReadsBypassTheReadBuffer) {
+    uint8_t readBuffer[16] = {};
+    ReadAheadBufferedCommunication comm(readBuffer, sizeof(readBuffer), 100);
+
+    uint8_t out[40] = {};
+    ASSERT_EQ(comm.read(out, sizeof(out)), sizeof(out));
+    EXPECT_EQ(comm.readCalls, 1u);
+    EXPECT_EQ(comm.lastReadSize, sizeof(out));
+    EXPECT_EQ(out[39], 39);
+    EXPECT_EQ(readBuffer[0], 0); // untouched
+}
+
+TEST(BufferedCommunicationTests, PeekConsumeAndFillWithoutCopies) {
+    uint8_t readBuffer[8] = {};
+    ReadAheadBufferedCommunication comm(readBuffer, sizeof(readBuffer), 20);
+
+    const uint8_t* data = nullptr;
+    ASSERT_EQ(comm.peek(data), 8u);
+    EXPECT_EQ(data, readBuffer);
+    EXPECT_EQ(data[7], 7);
+
+    // peek does not read again while bytes are buffered
+    comm.consume(6);
+    ASSERT_EQ(comm.peek(data), 2u);
+    EXPECT_EQ(data[0], 6);
+    EXPECT_EQ(comm.readCalls, 1u);
+
+    // fill moves the two bytes to the front and reads behind them
+    EXPECT_EQ(comm.fill(), 6u);
+    ASSERT_EQ(comm.peek(data), 8u);
+    EXPECT_EQ(data, readBuffer);
+    for (size_t i = 0; i < 8; i++) {
+        EXPECT_EQ(data[i], 6 + i);
+    }
+
+    EXPECT_EQ(comm.fill(), 0u); // full
+    comm.consume(8);
+    EXPECT_EQ(comm.peek(data), 6u);
+    EXPECT_EQ(data[5], 19);
+}
@@ -0,0 +1,90 @@
+#include "IntegralCommunication/FixedBlockPool.h"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <set>
+
+namespace {
+    class CountingWaiter : public FixedBlockPool::Waiter {
+      public:
+        void onBlockReleased() override {
+            wakeups++;
+        }
+
+        size_t wakeups = 0;
+    };
+} // namespace
+
+TEST(FixedBlockPoolTests, HandsOutEveryBlockOnceThenReportsExhaustion) {
+    uint8_t memory[4 * 16] = {};
+    FixedBlockPool pool(memory, 16, 4);
+    EXPECT_TRUE(pool.valid());
+    EXPECT_EQ(pool.freeBlocks(), 4u);
+
+    std::set<uint8_t*> blocks;
+    for (int i = 0; i < 4; i++) {
+        uint8_t* block = pool.acquire();
+        ASSERT_NE(block, nullptr);
+        EXPECT_GE(block, memory);
+        EXPECT_LE(block + 16, memory + sizeof(memory));
+        blocks.insert(block);
+    }
+    EXPECT_EQ(blocks.size(), 4u);
+    EXPECT_EQ(pool.freeBlocks(), 0u);
+
+    EXPECT_EQ(pool.acquire(), nullptr);
+    EXPECT_EQ(pool.exhaustions(), 1u);
+
+    uint8_t* returned = *blocks.begin();
+    pool.release(returned);
+    EXPECT_EQ(pool.freeBlocks(), 1u);
+    EXPECT_EQ(pool.acquire(), returned);
+    EXPECT_EQ(pool.lowWater(), 0u);
+}
+
+TEST(FixedBlockPoolTests, BlocksNeedNotBeAligned) {
+    uint8_t memory[1 + 3 * 9] = {};
+    FixedBlockPool pool(memory + 1, 9, 3);
+
+    uint8_t* first = pool.acquire();
+    uint8_t* second = pool.acquire();
+    EXPECT_EQ(first, memory + 1);
+    EXPECT_EQ(second, memory + 10);
+    pool.release(first);
+    pool.release(second);
+    EXPECT_EQ(pool.freeBlocks(), 3u);
+    EXPECT_EQ(pool.lowWater(), 1u);
+}
+
+TEST(FixedBlockPoolTests, BlocksSmallerThanAPointerLeaveThePoolEmpty) {
+    uint8_t memory[8] = {};
+    FixedBlockPool pool(memory, 2, 4);
+    EXPECT_FALSE(pool.valid());
+    EXPECT_EQ(pool.blockCount(), 0u);
+    EXPECT_EQ(pool.acquire(), nullptr);
+}
+
+TEST(FixedBlockPoolTests, ReleaseWakesEveryWaiterOnce) {
+    uint8_t memory[16] = {};
+    FixedBlockPool pool(memory, 16, 1);
+    uint8_t* block = pool.acquire();
+    ASSERT_NE(block, nullptr);
+
+    CountingWaiter first;
+    CountingWaiter second;
+    CountingWaiter cancelled;
+    pool.wait(first);
+    pool.wait(first);
+    pool.wait(second);
+    pool.wait(cancelled);
+    pool.cancelWait(cancelled);
+
+    pool.release(block);
+    EXPECT_EQ(first.wakeups, 1u);
+    EXPECT_EQ(second.wakeups, 1u);
+    EXPECT_EQ(cancelled.wakeups, 0u);
+
+    // Waiters are woken once per wait()
+    block = pool.acquire();
+    pool.release(block);
+    EXPECT_EQ(first.wakeups, 1u);
+}
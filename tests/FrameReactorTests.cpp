@@ -0,0 +1,366 @@
+#if defined(__linux__)
+
+#include "IntegralCommunication/FrameReactor.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+    using Link = SevenBitEncodedLink<64, 64>;
+
+    // Both ends of a socketpair, closed with the test
+    class SocketPair {
+      public:
+        SocketPair() {
+            if (::socketpair(AF_UNIX, SOCK_STREAM, 0, _fds) != 0) {
+                _fds[0] = _fds[1] = -1;
+            }
+        }
+
+        ~SocketPair() {
+            closeEnd(0);
+            closeEnd(1);
+        }
+
+        SocketPair(const SocketPair&) = delete;
+        SocketPair& operator=(const SocketPair&) = delete;
+
+        int end(int index) const {
+            return _fds[index];
+        }
+
+        void closeEnd(int index) {
+            if (_fds[index] >= 0) {
+                ::close(_fds[index]);
+                _fds[index] = -1;
+            }
+        }
+
+      private:
+        int _fds[2];
+    };
+
+    // Link that stops reading while it is told it has no room, as a link waiting for a buffer does
+    class PausingLink final : public ReactorLink {
+      public:
+        explicit PausingLink(int fd) : ReactorLink(_fd), _fd(fd, _backlog.data(), _backlog.size()), _comm(_fd) {}
+
+        void setFull(bool full) {
+            _full = full;
+            if (!full) {
+                resumeReading();
+            }
+        }
+
+        size_t readCalls = 0;
+
+      private:
+        bool encodeMessage(const uint8_t* data, size_t length) override {
+            return _comm.writeMessage(data, length);
+        }
+
+        size_t readFrames(const FrameHandler& handler) override {
+            readCalls++;
+            if (_full) {
+                pauseReading();
+                return 0;
+            }
+            return _comm.readMessages(handler);
+        }
+
+        std::array<uint8_t, 64> _backlog;
+        PosixFdCommunication _fd;
+        BasicSevenBitEncodedCommunication<PosixFdCommunication, 64, 64> _comm;
+        bool _full = false;
+    };
+
+    std::vector<uint8_t> toVector(const SevenBitMessageView& view) {
+        return std::vector<uint8_t>(view.data, view.data + view.size);
+    }
+
+    // Runs the reactor until done() holds, with a bound so a broken test fails instead of hanging
+    template <typename Done> bool runUntil(FrameReactor& reactor, Done&& done) {
+        for (int i = 0; i < 1000 && !done(); i++) {
+            if (reactor.runOnce(100) < 0) {
+                return false;
+            }
+        }
+        return done();
+    }
+} // namespace
+
+TEST(FrameReactorTests, DeliversFramesAndEchoes) {
+    SocketPair sockets;
+    FrameReactor reactor;
+    Link client(sockets.end(0));
+    Link server(sockets.end(1));
+
+    ASSERT_TRUE(reactor.valid());
+    ASSERT_TRUE(reactor.add(client));
+    ASSERT_TRUE(reactor.add(server));
+    EXPECT_EQ(reactor.linkCount(), 2u);
+
+    server.onFrame([&](const SevenBitMessageView& view) { server.writeMessage(view.data, view.size); });
+    std::vector<std::vector<uint8_t>> replies;
+    client.onFrame([&](const SevenBitMessageView& view) { replies.push_back(toVector(view)); });
+
+    const std::vector<uint8_t> first = {1, 2, 3};
+    const std::vector<uint8_t> second = {0xFF, 0x80, 0x00, 0x7F, 0x55};
+    ASSERT_TRUE(client.writeMessage(first.data(), first.size()));
+    ASSERT_TRUE(client.writeMessage(second.data(), second.size()));
+
+    ASSERT_TRUE(runUntil(reactor, [&] { return replies.size() == 2; }));
+    EXPECT_EQ(replies[0], first);
+    EXPECT_EQ(replies[1], second);
+
+    // Both directions are drained, so nothing is left to dispatch
+    EXPECT_EQ(reactor.runOnce(0), 0);
+}
+
+TEST(FrameReactorTests, ServesManyLinksFromOneThread) {
+    constexpr size_t LINK_COUNT = 200;
+    std::vector<std::unique_ptr<SocketPair>> sockets;
+    FrameReactor reactor;
+    std::vector<std::unique_ptr<Link>> clients;
+    std::vector<std::unique_ptr<Link>> servers;
+
+    size_t received = 0;
+    for (size_t i = 0; i < LINK_COUNT; i++) {
+        sockets.push_back(std::make_unique<SocketPair>());
+        clients.push_back(std::make_unique<Link>(sockets.back()->end(0)));
+        servers.push_back(std::make_unique<Link>(sockets.back()->end(1)));
+        ASSERT_TRUE(reactor.add(*servers.back()));
+
+        servers.back()->onFrame([&received, i](const SevenBitMessageView& view) {
+            EXPECT_EQ(view.size, 2u);
+            EXPECT_EQ(view.data[0], static_cast<uint8_t>(i));
+            EXPECT_EQ(view.data[1], static_cast<uint8_t>(i >> 8));
+            received++;
+        });
+    }
+
+    for (size_t i = 0; i < LINK_COUNT; i++) {
+        const uint8_t payload[] = {static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8)};
+        ASSERT_TRUE(clients[i]->writeMessage(payload, sizeof(payload)));
+    }
+
+    ASSERT_TRUE(runUntil(reactor, [&] { return received == LINK_COUNT; }));
+    EXPECT_EQ(reactor.linkCount(), LINK_COUNT);
+}
+
+TEST(FrameReactorTests, ReportsTxDrainedAfterBackpressure) {
+    int rx[2];
+    int tx[2];
+    ASSERT_EQ(::pipe(rx), 0);
+    ASSERT_EQ(::pipe(tx), 0);
+    const int pipeSize = ::fcntl(tx[1], F_SETPIPE_SZ, 4096);
+    ASSERT_GT(pipeSize, 0);
+    ASSERT_EQ(::fcntl(tx[0], F_SETFL, O_NONBLOCK), 0);
+
+    {
+        FrameReactor reactor;
+        SevenBitEncodedLink<16384, 64> link(rx[0], tx[1]);
+        ASSERT_TRUE(reactor.add(link));
+
+        size_t drained = 0;
+        link.onTxDrained([&] { drained++; });
+
+        const std::vector<uint8_t> payload(static_cast<size_t>(pipeSize) * 2, 0xA5);
+        ASSERT_TRUE(link.writeMessage(payload.data(), payload.size()));
+        EXPECT_EQ(link.transport().lastWriteStatus(), PosixFdCommunication::WriteStatus::Queued);
+
+        EXPECT_EQ(reactor.runOnce(0), 0);
+        EXPECT_EQ(drained, 0u);
+
+        std::vector<uint8_t> encoded;
+        std::vector<uint8_t> chunk(static_cast<size_t>(pipeSize));
+        ASSERT_TRUE(runUntil(reactor, [&] {
+            const ssize_t bytes = ::read(tx[0], chunk.data(), chunk.size());
+            if (bytes > 0) {
+                encoded.insert(encoded.end(), chunk.begin(), chunk.begin() + bytes);
+            }
+            return drained == 1 && link.transport().pendingTxBytes() == 0;
+        }));
+
+        const ssize_t rest = ::read(tx[0], chunk.data(), chunk.size());
+        if (rest > 0) {
+            encoded.insert(encoded.end(), chunk.begin(), chunk.begin() + rest);
+        }
+        ASSERT_EQ(encoded.size(), SevenBitEncoding::getEncodedBufferSize(payload.size()));
+        std::vector<uint8_t> decoded(payload.size());
+        EXPECT_EQ(SevenBitEncoding::decodeBuffer(encoded.data(), encoded.size(), decoded.data(), decoded.size()),
+                  payload.size());
+        EXPECT_EQ(decoded, payload);
+    }
+
+    for (const int fd : {rx[0], rx[1], tx[0], tx[1]}) {
+        ::close(fd);
+    }
+}
+
+TEST(FrameReactorTests, DeliversLastFramesThenClosesOnHangup) {
+    SocketPair sockets;
+    FrameReactor reactor;
+    auto server = std::make_unique<Link>(sockets.end(1));
+
+    ASSERT_TRUE(reactor.add(*server));
+
+    size_t frames = 0;
+    bool closed = false;
+    server->onFrame([&](const SevenBitMessageView&) { frames++; });
+    server->onClosed([&] {
+        closed = true;
+        server.reset(); // links may be destroyed from onClosed
+    });
+
+    {
+        Link client(sockets.end(0));
+        const uint8_t payload[] = {7, 8, 9};
+        ASSERT_TRUE(client.writeMessage(payload, sizeof(payload)));
+        ASSERT_TRUE(client.writeMessage(payload, sizeof(payload)));
+    }
+    sockets.closeEnd(0);
+
+    ASSERT_TRUE(runUntil(reactor, [&] { return closed; }));
+    EXPECT_EQ(frames, 2u);
+    EXPECT_EQ(server, nullptr);
+    EXPECT_EQ(reactor.linkCount(), 0u);
+}
+
+TEST(FrameReactorTests, RemovedLinkReceivesNothing) {
+    SocketPair sockets;
+    FrameReactor reactor;
+    Link client(sockets.end(0));
+    Link server(sockets.end(1));
+
+    ASSERT_TRUE(reactor.add(server));
+    EXPECT_FALSE(reactor.add(server));
+
+    size_t frames = 0;
+    server.onFrame([&](const SevenBitMessageView&) { frames++; });
+    ASSERT_TRUE(reactor.remove(server));
+    EXPECT_FALSE(reactor.remove(server));
+
+    const uint8_t payload[] = {1};
+    ASSERT_TRUE(client.writeMessage(payload, sizeof(payload)));
+    EXPECT_EQ(reactor.runOnce(0), 0);
+    EXPECT_EQ(frames, 0u);
+}
+
+TEST(FrameReactorTests, DestroyedLinkLeavesTheReactor) {
+    SocketPair sockets;
+    FrameReactor reactor;
+    Link client(sockets.end(0));
+    {
+        Link server(sockets.end(1));
+        ASSERT_TRUE(reactor.add(server));
+        EXPECT_EQ(reactor.linkCount(), 1u);
+    }
+    EXPECT_EQ(reactor.linkCount(), 0u);
+
+    const uint8_t payload[] = {1};
+    ASSERT_TRUE(client.writeMessage(payload, sizeof(payload)));
+    EXPECT_EQ(reactor.runOnce(0), 0);
+}
+
+TEST(FrameReactorTests, PooledLinksShareBlocks) {
+    constexpr size_t LINK_COUNT = 50;
+    std::vector<uint8_t> memory(4 * 64);
+    FixedBlockPool pool(memory.data(), 64, 4);
+
+    std::vector<std::unique_ptr<SocketPair>> sockets;
+    FrameReactor reactor;
+    std::vector<std::unique_ptr<Link>> clients;
+    std::vector<std::unique_ptr<PooledSevenBitEncodedLink<>>> servers;
+
+    size_t echoed = 0;
+    for (size_t i = 0; i < LINK_COUNT; i++) {
+        sockets.push_back(std::make_unique<SocketPair>());
+        clients.push_back(std::make_unique<Link>(sockets.back()->end(0)));
+        servers.push_back(std::make_unique<PooledSevenBitEncodedLink<>>(sockets.back()->end(1), pool));
+        ASSERT_TRUE(reactor.add(*clients.back()));
+        ASSERT_TRUE(reactor.add(*servers.back()));
+
+        auto& server = *servers.back();
+        server.onFrame([&server](const SevenBitMessageView& view) { server.writeMessage(view.data, view.size); });
+        clients.back()->onFrame([&echoed, i](const SevenBitMessageView& view) {
+            EXPECT_EQ(view.size, 1u);
+            EXPECT_EQ(view.data[0], static_cast<uint8_t>(i));
+            echoed++;
+        });
+    }
+
+    for (size_t i = 0; i < LINK_COUNT; i++) {
+        const uint8_t payload[] = {static_cast<uint8_t>(i)};
+        ASSERT_TRUE(clients[i]->writeMessage(payload, sizeof(payload)));
+    }
+
+    ASSERT_TRUE(runUntil(reactor, [&] { return echoed == LINK_COUNT; }));
+    EXPECT_EQ(pool.freeBlocks(), pool.blockCount());
+    for (const auto& server : servers) {
+        EXPECT_FALSE(server->communication().holdsRxBuffer());
+    }
+}
+
+TEST(FrameReactorTests, PausedLinkDoesNotWakeTheReactor) {
+    SocketPair sockets;
+    FrameReactor reactor;
+    Link client(sockets.end(0));
+    PausingLink server(sockets.end(1));
+    ASSERT_TRUE(reactor.add(server));
+
+    size_t frames = 0;
+    server.onFrame([&](const SevenBitMessageView&) { frames++; });
+    server.setFull(true);
+
+    const uint8_t payload[] = {1, 2, 3};
+    ASSERT_TRUE(client.writeMessage(payload, sizeof(payload)));
+    EXPECT_EQ(reactor.runOnce(1000), 1);
+    EXPECT_EQ(server.readCalls, 1u);
+
+    // The bytes are still in the socket, but the reactor sleeps for the whole timeout
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(reactor.runOnce(50), 0);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(40));
+    EXPECT_EQ(server.readCalls, 1u);
+
+    server.setFull(false);
+    ASSERT_TRUE(runUntil(reactor, [&] { return frames == 1; }));
+}
+
+TEST(FrameReactorTests, PooledLinkSleepsWhileThePoolIsEmpty) {
+    std::vector<uint8_t> memory(64);
+    FixedBlockPool pool(memory.data(), 64, 1);
+
+    SocketPair sockets;
+    FrameReactor reactor;
+    Link client(sockets.end(0));
+    PooledSevenBitEncodedLink<> server(sockets.end(1), pool);
+    ASSERT_TRUE(reactor.add(server));
+
+    size_t frames = 0;
+    server.onFrame([&](const SevenBitMessageView&) { frames++; });
+
+    uint8_t* taken = pool.acquire();
+    ASSERT_NE(taken, nullptr);
+    const uint8_t payload[] = {4, 5, 6};
+    ASSERT_TRUE(client.writeMessage(payload, sizeof(payload)));
+    EXPECT_EQ(reactor.runOnce(1000), 1);
+    EXPECT_TRUE(server.communication().waitingForRxBlock());
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(reactor.runOnce(50), 0);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(40));
+
+    pool.release(taken);
+    ASSERT_TRUE(runUntil(reactor, [&] { return frames == 1; }));
+    EXPECT_EQ(pool.freeBlocks(), 1u);
+}
+
+#endif
@@ -0,0 +1,197 @@
+#include "IntegralCommunication/PooledSevenBitEncodedCommunication.h"
+#include "IntegralCommunication/SevenBitEncodedCommunication.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+namespace {
+    // In-memory transport; bytes pushed with pushIncoming are read back by the communication
+    class LoopbackTransport {
+      public:
+        void write(const uint8_t* data, size_t size) {
+            written.insert(written.end(), data, data + size);
+        }
+
+        size_t available() const {
+            return _incoming.size();
+        }
+
+        size_t read(uint8_t* data, size_t size) {
+            const size_t toRead = std::min(size, _incoming.size());
+            std::memcpy(data, _incoming.data(), toRead);
+            _incoming.erase(_incoming.begin(), _incoming.begin() + static_cast<std::ptrdiff_t>(toRead));
+            return toRead;
+        }
+
+        void pushIncoming(const std::vector<uint8_t>& data) {
+            _incoming.insert(_incoming.end(), data.begin(), data.end());
+        }
+
+        std::vector<uint8_t> written;
+
+      private:
+        std::vector<uint8_t> _incoming;
+    };
+
+    using PooledComm = PooledSevenBitEncodedCommunication<LocalCounterStats, LoopbackTransport>;
+
+    std::vector<uint8_t> encode(const std::vector<uint8_t>& payload) {
+        std::vector<uint8_t> encoded(SevenBitEncoding::getEncodedBufferSize(payload.size()));
+        encoded.resize(SevenBitEncoding::encodeBuffer(payload.data(), payload.size(), encoded.data()));
+        return encoded;
+    }
+
+    std::vector<uint8_t> readOne(PooledComm& comm) {
+        std::vector<uint8_t> out(64);
+        size_t outLen = 0;
+        if (!comm.readMessage(out.data(), out.size(), outLen)) {
+            return {};
+        }
+        out.resize(outLen);
+        return out;
+    }
+} // namespace
+
+static_assert(10 * sizeof(PooledSevenBitEncodedCommunication<NoStats, LoopbackTransport>) <
+                  sizeof(BasicSevenBitEncodedCommunication<LoopbackTransport, 256, 1024>),
+              "a link without buffers is a few pointers and indices");
+
+TEST(PooledSevenBitEncodedCommunicationTests, IdleLinksHoldNoBlocks) {
+    std::vector<uint8_t> memory(4 * 32);
+    FixedBlockPool pool(memory.data(), 32, 4);
+
+    // Far more links than blocks
+    std::vector<std::unique_ptr<LoopbackTransport>> transports;
+    std::vector<std::unique_ptr<PooledComm>> links;
+    for (int i = 0; i < 100; i++) {
+        transports.push_back(std::make_unique<LoopbackTransport>());
+        links.push_back(std::make_unique<PooledComm>(*transports.back(), pool));
+    }
+
+    for (auto& link : links) {
+        EXPECT_TRUE(readOne(*link).empty());
+    }
+    EXPECT_EQ(pool.freeBlocks(), 4u);
+
+    const std::vector<uint8_t> payload = {1, 2, 3, 0xFF};
+    for (size_t i = 0; i < links.size(); i++) {
+        ASSERT_TRUE(links[i]->writeMessage(payload.data(), payload.size()));
+        transports[i]->pushIncoming(transports[i]->written);
+        EXPECT_EQ(readOne(*links[i]), payload);
+        EXPECT_FALSE(links[i]->holdsRxBuffer());
+    }
+    EXPECT_EQ(pool.freeBlocks(), 4u);
+    EXPECT_EQ(pool.lowWater(), 3u);
+}
+
+TEST(PooledSevenBitEncodedCommunicationTests, ExhaustedPoolLeavesBytesInTransport) {
+    std::vector<uint8_t> memory(32);
+    FixedBlockPool pool(memory.data(), 32, 1);
+    LoopbackTransport busyTransport;
+    LoopbackTransport waitingTransport;
+    PooledComm busy(busyTransport, pool);
+    PooledComm waiting(waitingTransport, pool);
+
+    // The first half of a frame keeps the only block borrowed
+    const std::vector<uint8_t> first = encode({10, 20, 30, 40, 50, 60, 70, 80, 90});
+    busyTransport.pushIncoming(std::vector<uint8_t>(first.begin(), first.begin() + 4));
+    EXPECT_TRUE(readOne(busy).empty());
+    EXPECT_TRUE(busy.holdsRxBuffer());
+
+    const std::vector<uint8_t> second = encode({1, 2, 3});
+    waitingTransport.pushIncoming(second);
+    EXPECT_TRUE(readOne(waiting).empty());
+    EXPECT_EQ(waitingTransport.available(), second.size());
+    EXPECT_EQ(pool.exhaustions(), 1u);
+
+    const uint8_t payload[] = {1};
+    EXPECT_FALSE(busy.writeMessage(payload, sizeof(payload)));
+    EXPECT_EQ(busy.stats().framesRejected(), 1u);
+
+    busyTransport.pushIncoming(std::vector<uint8_t>(first.begin() + 4, first.end()));
+    EXPECT_EQ(readOne(busy), (std::vector<uint8_t>{10, 20, 30, 40, 50, 60, 70, 80, 90}));
+    EXPECT_EQ(readOne(waiting), (std::vector<uint8_t>{1, 2, 3}));
+    EXPECT_EQ(pool.freeBlocks(), 1u);
+}
+
+TEST(PooledSevenBitEncodedCommunicationTests, RejectsFramesLargerThanABlock) {
+    std::vector<uint8_t> memory(2 * 16);
+    FixedBlockPool pool(memory.data(), 16, 2);
+    LoopbackTransport transport;
+    PooledComm comm(transport, pool);
+
+    const std::vector<uint8_t> large(20, 0x42);
+    EXPECT_FALSE(comm.writeMessage(large.data(), large.size()));
+    EXPECT_TRUE(transport.written.empty());
+
+    // An oversized incoming frame is dropped and the one behind it still arrives
+    transport.pushIncoming(encode(large));
+    transport.pushIncoming(encode({7, 8}));
+    std::vector<std::vector<uint8_t>> frames;
+    for (int i = 0; i < 4 && frames.empty(); i++) {
+        comm.readMessages(
+            [&](const SevenBitMessageView& view) { frames.emplace_back(view.data, view.data + view.size); });
+    }
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0], (std::vector<uint8_t>{7, 8}));
+    EXPECT_EQ(comm.discardedBytes(), encode(large).size());
+}
+
+TEST(PooledSevenBitEncodedCommunicationTests, ViewKeepsBlockUntilNextRead) {
+    std::vector<uint8_t> memory(32);
+    FixedBlockPool pool(memory.data(), 32, 1);
+    LoopbackTransport transport;
+    PooledComm comm(transport, pool);
+
+    transport.pushIncoming(encode({5, 6, 7}));
+    SevenBitMessageView view;
+    ASSERT_TRUE(comm.readMessageView(view));
+    EXPECT_EQ(std::vector<uint8_t>(view.data, view.data + view.size), (std::vector<uint8_t>{5, 6, 7}));
+    EXPECT_EQ(pool.freeBlocks(), 0u);
+
+    EXPECT_FALSE(comm.readMessageView(view));
+    EXPECT_EQ(pool.freeBlocks(), 1u);
+}
+
+TEST(PooledSevenBitEncodedCommunicationTests, ReadMessagesGivesTheBlockBack) {
+    std::vector<uint8_t> memory(32);
+    FixedBlockPool pool(memory.data(), 32, 1);
+    LoopbackTransport transport;
+    PooledComm comm(transport, pool);
+
+    transport.pushIncoming(encode({1, 2}));
+    transport.pushIncoming(encode({3, 4, 5}));
+    size_t frames = 0;
+    EXPECT_EQ(comm.readMessages([&](const SevenBitMessageView&) { frames++; }), 2u);
+    EXPECT_EQ(frames, 2u);
+    EXPECT_FALSE(comm.holdsRxBuffer());
+    EXPECT_EQ(pool.freeBlocks(), 1u);
+
+    // A partial frame keeps it
+    const std::vector<uint8_t> partial = encode({6, 7, 8, 9, 10, 11, 12, 13});
+    transport.pushIncoming(std::vector<uint8_t>(partial.begin(), partial.begin() + 3));
+    EXPECT_EQ(comm.readMessages([&](const SevenBitMessageView&) { frames++; }), 0u);
+    EXPECT_TRUE(comm.holdsRxBuffer());
+}
+
+TEST(PooledSevenBitEncodedCommunicationTests, ViewsKeepTheBlockUntilReleased) {
+    std::vector<uint8_t> memory(32);
+    FixedBlockPool pool(memory.data(), 32, 1);
+    LoopbackTransport transport;
+    PooledComm comm(transport, pool);
+
+    transport.pushIncoming(encode({1, 2}));
+    transport.pushIncoming(encode({3, 4, 5}));
+    SevenBitMessageView views[4];
+    ASSERT_EQ(comm.readMessages(views, 4), 2u);
+    EXPECT_TRUE(comm.holdsRxBuffer());
+    EXPECT_EQ(std::vector<uint8_t>(views[0].data, views[0].data + views[0].size), (std::vector<uint8_t>{1, 2}));
+    EXPECT_EQ(std::vector<uint8_t>(views[1].data, views[1].data + views[1].size), (std::vector<uint8_t>{3, 4, 5}));
+
+    comm.releaseRxBuffer();
+    EXPECT_FALSE(comm.holdsRxBuffer());
+    EXPECT_EQ(pool.freeBlocks(), 1u);
+}
@@ -0,0 +1,242 @@
+#if defined(__linux__)
+
+#include "IntegralCommunication/EpollPoller.h"
+#include "IntegralCommunication/PosixFdCommunication.h"
+#include "IntegralCommunication/SevenBitEncodedCommunication.h"
+#include "IntegralCommunication/SevenBitEncoding.h"
+#include <cstdint>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+    // Pipe whose ends are closed with the test
+    class Pipe {
+      public:
+        Pipe() {
+            if (::pipe(_fds) != 0) {
+                _fds[0] = _fds[1] = -1;
+            }
+        }
+
+        ~Pipe() {
+            closeWriteEnd();
+            if (_fds[0] >= 0) {
+                ::close(_fds[0]);
+            }
+        }
+
+        Pipe(const Pipe&) = delete;
+        Pipe& operator=(const Pipe&) = delete;
+
+        int readEnd() const {
+            return _fds[0];
+        }
+
+        int writeEnd() const {
+            return _fds[1];
+        }
+
+        void closeWriteEnd() {
+            if (_fds[1] >= 0) {
+                ::close(_fds[1]);
+                _fds[1] = -1;
+            }
+        }
+
+      private:
+        int _fds[2];
+    };
+
+    std::vector<uint8_t> encode(const std::vector<uint8_t>& payload) {
+        std::vector<uint8_t> encoded(SevenBitEncoding::getEncodedBufferSize(payload.size()));
+        encoded.resize(SevenBitEncoding::encodeBuffer(payload.data(), payload.size(), encoded.data()));
+        return encoded;
+    }
+} // namespace
+
+TEST(PosixFdCommunicationTests, FramesRoundTripThroughPipe) {
+    Pipe pipe;
+    uint8_t backlog[64];
+    PosixFdCommunication fd(pipe.readEnd(), pipe.writeEnd(), backlog, sizeof(backlog));
+    SevenBitEncodedCommunication<64, 64> comm(fd);
+
+    const std::vector<uint8_t> payload = {0x10, 0x20, 0xFF, 0x00, 0x7F};
+    ASSERT_TRUE(comm.writeMessage(payload.data(), payload.size()));
+    EXPECT_EQ(fd.lastWriteStatus(), PosixFdCommunication::WriteStatus::Complete);
+    EXPECT_EQ(fd.available(), SevenBitEncoding::getEncodedBufferSize(payload.size()));
+
+    std::vector<uint8_t> out(16);
+    size_t outLen = 0;
+    ASSERT_TRUE(comm.readMessage(out.data(), out.size(), outLen));
+    out.resize(outLen);
+    EXPECT_EQ(out, payload);
+
+    // Nothing left: non-blocking read returns immediately
+    EXPECT_FALSE(comm.readMessage(out.data(), out.size(), outLen));
+}
+
+TEST(PosixFdCommunicationTests, WriteVectoredSendsFramesInOneCall) {
+    Pipe pipe;
+    uint8_t backlog[64];
+    PosixFdCommunication fd(pipe.readEnd(), pipe.writeEnd(), backlog, sizeof(backlog));
+
+    std::vector<uint8_t> first = encode({1, 2, 3});
+    std::vector<uint8_t> second = encode({4, 5, 6, 7, 8, 9, 10, 11});
+    const iovec buffers[] = {{first.data(), first.size()}, {second.data(), second.size()}};
+    EXPECT_EQ(fd.writeVectored(buffers, 2), PosixFdCommunication::WriteStatus::Complete);
+
+    std::vector<uint8_t> received(first.size() + second.size());
+    ASSERT_EQ(fd.read(received.data(), received.size()), received.size());
+    std::vector<uint8_t> expected = first;
+    expected.insert(expected.end(), second.begin(), second.end());
+    EXPECT_EQ(received, expected);
+}
+
+TEST(PosixFdCommunicationTests, FullPipeQueuesThenDropsAndFlushesInOrder) {
+    Pipe pipe;
+    const int pipeSize = ::fcntl(pipe.writeEnd(), F_SETPIPE_SZ, 4096);
+    ASSERT_GT(pipeSize, 0);
+
+    std::vector<uint8_t> backlog(256);
+    PosixFdCommunication fd(pipe.readEnd(), pipe.writeEnd(), backlog.data(), backlog.size());
+
+    // Fill the pipe completely, then one more chunk is kept back
+    std::vector<uint8_t> chunk(static_cast<size_t>(pipeSize), 0x80);
+    ASSERT_EQ(::write(pipe.writeEnd(), chunk.data(), chunk.size()), pipeSize);
+
+    const std::vector<uint8_t> tail = {1, 2, 3, 4};
+    fd.write(tail.data(), tail.size());
+    EXPECT_EQ(fd.lastWriteStatus(), PosixFdCommunication::WriteStatus::Queued);
+    EXPECT_EQ(fd.pendingTxBytes(), tail.size());
+
+    // The backlog cannot take this one, so it is dropped as a whole
+    const std::vector<uint8_t> large(backlog.size(), 0x55);
+    fd.write(large.data(), large.size());
+    EXPECT_EQ(fd.lastWriteStatus(), PosixFdCommunication::WriteStatus::Dropped);
+    EXPECT_EQ(fd.droppedTxBytes(), large.size());
+
+    EXPECT_FALSE(fd.flushPending());
+    std::vector<uint8_t> drained(chunk.size());
+    ASSERT_EQ(fd.read(drained.data(), drained.size()), drained.size());
+    EXPECT_TRUE(fd.flushPending());
+    EXPECT_EQ(fd.pendingTxBytes(), 0u);
+
+    std::vector<uint8_t> received(tail.size());
+    ASSERT_EQ(fd.read(received.data(), received.size()), tail.size());
+    EXPECT_EQ(received, tail);
+    EXPECT_EQ(fd.lastError(), 0);
+}
+
+TEST(PosixFdCommunicationTests, IdleDescriptorTakesWritesLargerThanTheBacklog) {
+    Pipe pipe;
+    uint8_t backlog[8];
+    PosixFdCommunication fd(pipe.readEnd(), pipe.writeEnd(), backlog, sizeof(backlog));
+
+    const std::vector<uint8_t> frame = encode(std::vector<uint8_t>(64, 0x44));
+    fd.write(frame.data(), frame.size());
+    EXPECT_EQ(fd.lastWriteStatus(), PosixFdCommunication::WriteStatus::Complete);
+    EXPECT_EQ(fd.droppedTxBytes(), 0u);
+
+    std::vector<uint8_t> received(frame.size());
+    ASSERT_EQ(fd.read(received.data(), received.size()), frame.size());
+    EXPECT_EQ(received, frame);
+}
+
+TEST(PosixFdCommunicationTests, PartialWriteQueuesTheRestAndNeverCutsAFrame) {
+    Pipe pipe;
+    const int pipeSize = ::fcntl(pipe.writeEnd(), F_SETPIPE_SZ, 4096);
+    ASSERT_GT(pipeSize, 0);
+
+    std::vector<uint8_t> backlog(8192);
+    PosixFdCommunication fd(pipe.readEnd(), pipe.writeEnd(), backlog.data(), backlog.size());
+
+    // The pipe takes what it can, the rest is queued. Writes up to PIPE_BUF are all or nothing, so the frame is
+    // larger.
+    const std::vector<uint8_t> first = encode(std::vector<uint8_t>(static_cast<size_t>(pipeSize), 0x22));
+    fd.write(first.data(), first.size());
+    EXPECT_EQ(fd.lastWriteStatus(), PosixFdCommunication::WriteStatus::Queued);
+    EXPECT_EQ(fd.pendingTxBytes(), first.size() - static_cast<size_t>(pipeSize));
+
+    // Would fit in an empty backlog but not behind the queued bytes, so none of it goes out
+    const std::vector<uint8_t> second = encode(std::vector<uint8_t>(6800, 0x33));
+    fd.write(second.data(), second.size());
+    EXPECT_EQ(fd.lastWriteStatus(), PosixFdCommunication::WriteStatus::Dropped);
+    EXPECT_EQ(fd.droppedTxBytes(), second.size());
+
+    std::vector<uint8_t> received(first.size());
+    ASSERT_EQ(fd.read(received.data(), static_cast<size_t>(pipeSize)), static_cast<size_t>(pipeSize));
+    EXPECT_TRUE(fd.flushPending());
+    const size_t rest = first.size() - static_cast<size_t>(pipeSize);
+    ASSERT_EQ(fd.read(received.data() + pipeSize, rest), rest);
+    EXPECT_EQ(received, first);
+    EXPECT_EQ(fd.available(), 0u);
+}
+
+TEST(PosixFdCommunicationTests, PooledBacklogIsHeldOnlyWhileBytesWait) {
+    Pipe pipe;
+    const int pipeSize = ::fcntl(pipe.writeEnd(), F_SETPIPE_SZ, 4096);
+    ASSERT_GT(pipeSize, 0);
+
+    std::vector<uint8_t> memory(64);
+    FixedBlockPool pool(memory.data(), 64, 1);
+    PosixFdCommunication fd(pipe.readEnd(), pipe.writeEnd(), pool);
+
+    const std::vector<uint8_t> frame = encode({1, 2, 3});
+    fd.write(frame.data(), frame.size());
+    EXPECT_EQ(fd.lastWriteStatus(), PosixFdCommunication::WriteStatus::Complete);
+    EXPECT_EQ(pool.freeBlocks(), 1u);
+
+    std::vector<uint8_t> filler(static_cast<size_t>(pipeSize) - frame.size(), 0x80);
+    ASSERT_EQ(::write(pipe.writeEnd(), filler.data(), filler.size()), static_cast<ssize_t>(filler.size()));
+    fd.write(frame.data(), frame.size());
+    EXPECT_EQ(fd.lastWriteStatus(), PosixFdCommunication::WriteStatus::Queued);
+    EXPECT_EQ(pool.freeBlocks(), 0u);
+
+    std::vector<uint8_t> drained(static_cast<size_t>(pipeSize));
+    ASSERT_EQ(fd.read(drained.data(), drained.size()), drained.size());
+    EXPECT_TRUE(fd.flushPending());
+    EXPECT_EQ(pool.freeBlocks(), 1u);
+
+    // Without a free block nothing is sent, so no frame can be cut short
+    uint8_t* taken = pool.acquire();
+    fd.write(frame.data(), frame.size());
+    EXPECT_EQ(fd.lastWriteStatus(), PosixFdCommunication::WriteStatus::Dropped);
+    EXPECT_EQ(fd.available(), frame.size());
+    pool.release(taken);
+}
+
+TEST(PosixFdCommunicationTests, ReadReportsEndOfFile) {
+    Pipe pipe;
+    uint8_t backlog[8];
+    PosixFdCommunication fd(pipe.readEnd(), pipe.writeEnd(), backlog, sizeof(backlog));
+
+    pipe.closeWriteEnd();
+    uint8_t byte = 0;
+    EXPECT_EQ(fd.read(&byte, 1), 0u);
+    EXPECT_TRUE(fd.closed());
+}
+
+TEST(EpollPollerTests, ReportsReadableDescriptorWithContext) {
+    Pipe pipe;
+    uint8_t backlog[8];
+    PosixFdCommunication fd(pipe.readEnd(), pipe.writeEnd(), backlog, sizeof(backlog));
+
+    EpollPoller poller;
+    ASSERT_TRUE(poller.valid());
+    ASSERT_TRUE(poller.add(fd.readFd(), EPOLLIN, &fd));
+
+    epoll_event events[4];
+    EXPECT_EQ(poller.wait(events, 4, 0), 0);
+
+    const uint8_t byte = 0x01;
+    fd.write(&byte, 1);
+    ASSERT_EQ(poller.wait(events, 4, 1000), 1);
+    EXPECT_EQ(events[0].data.ptr, &fd);
+    EXPECT_NE(events[0].events & EPOLLIN, 0u);
+
+    EXPECT_TRUE(poller.remove(fd.readFd()));
+}
+
+#endif
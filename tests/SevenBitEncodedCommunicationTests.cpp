@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <cstring>
 #include <gtest/gtest.h>
+#include <type_traits>
 #include <vector>
 
 // ---------------------------
@@ -17,6 +18,14 @@ class FakeCommunication : public Communication {
         return _written;
     }
 
+    size_t reads() const {
+        return _reads;
+    }
+
+    size_t writes() const {
+        return _writes;
+    }
+
     // Test helper: push incoming encoded bytes that will be "read" by SevenBitEncodedCommunication.
     void pushIncoming(const std::vector<uint8_t>& data) {
         _incoming.insert(_incoming.end(), data.begin(), data.end());
@@ -24,6 +33,7 @@ class FakeCommunication : public Communication {
 
   private:
     void writeImpl(const uint8_t* data, size_t size) override {
+        _writes++;
         _written.insert(_written.end(), data, data + size);
     }
 
@@ -32,6 +42,7 @@ class FakeCommunication : public Communication {
     }
 
     size_t readImpl(uint8_t* data, size_t size) override {
+        _reads++;
         const size_t toRead = std::min(size, _incoming.size());
         if (toRead == 0) {
             return 0;
@@ -43,6 +54,8 @@ class FakeCommunication : public Communication {
 
     std::vector<uint8_t> _written;
     std::vector<uint8_t> _incoming;
+    size_t _reads = 0;
+    size_t _writes = 0;
 };
 
 // Use reasonably sized buffers for tests
@@ -177,3 +190,362 @@ TEST(SevenBitEncodedCommunicationTests, ReadTwoMessagesBackToBack) {
     EXPECT_FALSE(result);
     EXPECT_EQ(outLen, 0u);
 }
+
+TEST(SevenBitEncodedCommunicationTests, ReadMessageAssemblesFrameFromSmallReads) {
+    FakeCommunication fake;
+    SevenBitEncodedCommunication<16, 512> comm(fake);
+
+    std::vector<uint8_t> payload(300);
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<uint8_t>(i * 7);
+    }
+    std::vector<uint8_t> encoded(SevenBitEncoding::getEncodedBufferSize(payload.size()));
+    encoded.resize(SevenBitEncoding::encodeBuffer(payload.data(), payload.size(), encoded.data()));
+
+    std::vector<uint8_t> out(payload.size());
+    size_t outLen = 0;
+    for (size_t i = 0; i + 1 < encoded.size(); i += 3) {
+        const size_t end = std::min(i + 3, encoded.size() - 1);
+        fake.pushIncoming(std::vector<uint8_t>(encoded.begin() + static_cast<std::ptrdiff_t>(i),
+                                               encoded.begin() + static_cast<std::ptrdiff_t>(end)));
+        ASSERT_FALSE(comm.readMessage(out.data(), out.size(), outLen));
+    }
+
+    // The terminator arrives together with the start of the next frame
+    fake.pushIncoming({encoded.back(), 0x81});
+    ASSERT_TRUE(comm.readMessage(out.data(), out.size(), outLen));
+    EXPECT_EQ(outLen, payload.size());
+    EXPECT_EQ(out, payload);
+
+    fake.pushIncoming({0x00});
+    ASSERT_TRUE(comm.readMessage(out.data(), out.size(), outLen));
+    EXPECT_EQ(outLen, 1u);
+    EXPECT_EQ(out[0], 0x02);
+}
+
+TEST(SevenBitEncodedCommunicationTests, ReadMessageViewDecodesInPlace) {
+    FakeCommunication fake;
+    EncodedComm comm(fake);
+
+    const std::vector<uint8_t> msg1 = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09};
+    const std::vector<uint8_t> msg2 = {0xAA, 0xBB};
+
+    std::vector<uint8_t> combined;
+    for (const auto* msg : {&msg1, &msg2}) {
+        std::vector<uint8_t> enc(SevenBitEncoding::getEncodedBufferSize(msg->size()));
+        enc.resize(SevenBitEncoding::encodeBuffer(msg->data(), msg->size(), enc.data()));
+        combined.insert(combined.end(), enc.begin(), enc.end());
+    }
+    fake.pushIncoming(combined);
+
+    SevenBitMessageView view;
+    ASSERT_TRUE(comm.readMessageView(view));
+    EXPECT_EQ(std::vector<uint8_t>(view.data, view.data + view.size), msg1);
+
+    // Mixing both read styles keeps the frame order
+    uint8_t out[32] = {};
+    size_t outLen = 0;
+    ASSERT_TRUE(comm.readMessage(out, sizeof(out), outLen));
+    EXPECT_EQ(std::vector<uint8_t>(out, out + outLen), msg2);
+
+    EXPECT_FALSE(comm.readMessageView(view));
+    EXPECT_EQ(view.size, 0u);
+    EXPECT_EQ(comm.pendingBytes(), 0u);
+}
+
+TEST(SevenBitEncodedCommunicationTests, WriteMessageInPlaceNeedsNoTxBuffer) {
+    FakeCommunication fake;
+    SevenBitEncodedCommunication<0, 64> comm(fake);
+
+    const std::vector<uint8_t> payload = {0x01, 0x02, 0xFF, 0x10, 0x20, 0x30, 0x40, 0x50};
+    std::vector<uint8_t> expected(SevenBitEncoding::getEncodedBufferSize(payload.size()));
+    expected.resize(SevenBitEncoding::encodeBuffer(payload.data(), payload.size(), expected.data()));
+
+    std::vector<uint8_t> buffer(payload);
+    EXPECT_FALSE(comm.writeMessageInPlace(buffer.data(), payload.size(), buffer.size()));
+    EXPECT_TRUE(fake.written().empty());
+
+    buffer.resize(SevenBitEncoding::getEncodedBufferSize(payload.size()));
+    ASSERT_TRUE(comm.writeMessageInPlace(buffer.data(), payload.size(), buffer.size()));
+    EXPECT_EQ(fake.written(), expected);
+}
+
+namespace {
+    std::vector<uint8_t> encodeFrames(const std::vector<std::vector<uint8_t>>& messages) {
+        std::vector<uint8_t> stream;
+        for (const auto& msg : messages) {
+            std::vector<uint8_t> enc(SevenBitEncoding::getEncodedBufferSize(msg.size()));
+            enc.resize(SevenBitEncoding::encodeBuffer(msg.data(), msg.size(), enc.data()));
+            stream.insert(stream.end(), enc.begin(), enc.end());
+        }
+        return stream;
+    }
+} // namespace
+
+TEST(SevenBitEncodedCommunicationTests, ReadMessagesDrainsEveryFrameWithOneRead) {
+    FakeCommunication fake;
+    EncodedComm comm(fake);
+
+    const std::vector<std::vector<uint8_t>> messages = {
+        {0x01}, {0x02, 0x03}, {0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B}, {0xFF}};
+    std::vector<uint8_t> stream = encodeFrames(messages);
+    stream.push_back(0x81); // start of a frame that is still incomplete
+    fake.pushIncoming(stream);
+
+    std::vector<std::vector<uint8_t>> received;
+    const size_t count = comm.readMessages(
+        [&](const SevenBitMessageView& view) { received.emplace_back(view.data, view.data + view.size); });
+
+    EXPECT_EQ(count, messages.size());
+    EXPECT_EQ(received, messages);
+    EXPECT_EQ(fake.reads(), 1u);
+    EXPECT_EQ(comm.pendingBytes(), 1u);
+
+    fake.pushIncoming({0x00});
+    uint8_t out[8] = {};
+    size_t outLen = 0;
+    ASSERT_TRUE(comm.readMessage(out, sizeof(out), outLen));
+    EXPECT_EQ(outLen, 1u);
+    EXPECT_EQ(out[0], 0x02);
+}
+
+TEST(SevenBitEncodedCommunicationTests, ReadMessagesFillsViewArray) {
+    FakeCommunication fake;
+    EncodedComm comm(fake);
+
+    const std::vector<std::vector<uint8_t>> messages = {{0x10}, {0x20, 0x21}, {0x30}};
+    fake.pushIncoming(encodeFrames(messages));
+
+    SevenBitMessageView views[2];
+    ASSERT_EQ(comm.readMessages(views, 2), 2u);
+    EXPECT_EQ(std::vector<uint8_t>(views[0].data, views[0].data + views[0].size), messages[0]);
+    EXPECT_EQ(std::vector<uint8_t>(views[1].data, views[1].data + views[1].size), messages[1]);
+
+    ASSERT_EQ(comm.readMessages(views, 2), 1u);
+    EXPECT_EQ(std::vector<uint8_t>(views[0].data, views[0].data + views[0].size), messages[2]);
+    EXPECT_EQ(comm.readMessages(views, 2), 0u);
+}
+
+TEST(SevenBitEncodedCommunicationTests, CorkedMessagesGoOutInOneWrite) {
+    FakeCommunication fake;
+    EncodedComm comm(fake);
+
+    const std::vector<std::vector<uint8_t>> messages = {{0x01, 0x02}, {0x03}, {0x04, 0x05, 0x06}};
+
+    comm.cork();
+    for (const auto& msg : messages) {
+        ASSERT_TRUE(comm.writeMessage(msg.data(), msg.size()));
+    }
+    EXPECT_EQ(fake.writes(), 0u);
+
+    comm.uncork();
+    EXPECT_EQ(fake.writes(), 1u);
+    EXPECT_EQ(fake.written(), encodeFrames(messages));
+
+    // Uncorked, every message is written on its own again
+    ASSERT_TRUE(comm.writeMessage(messages[0].data(), messages[0].size()));
+    EXPECT_EQ(fake.writes(), 2u);
+}
+
+TEST(SevenBitEncodedCommunicationTests, WriteMessagesFlushesWholeFramesWhenTxBufferFills) {
+    FakeCommunication fake;
+    SevenBitEncodedCommunication<8, 8> comm(fake);
+
+    // 3 bytes encode to 4, so two frames fit per write
+    const std::vector<std::vector<uint8_t>> messages = {{0x01, 0x02, 0x03}, {0x04, 0x05, 0x06}, {0x07, 0x08, 0x09}};
+    std::vector<SevenBitMessageView> views;
+    for (const auto& msg : messages) {
+        views.push_back({msg.data(), msg.size()});
+    }
+    const std::vector<uint8_t> tooLarge(8, 0xAA);
+    views.push_back({tooLarge.data(), tooLarge.size()});
+
+    EXPECT_EQ(comm.writeMessages(views.data(), views.size()), messages.size());
+    EXPECT_EQ(fake.writes(), 2u);
+    EXPECT_EQ(fake.written(), encodeFrames(messages));
+}
+
+TEST(SevenBitEncodedCommunicationTests, WriteMessageAcceptsFixedSizeArrays) {
+    FakeCommunication fake;
+    SevenBitEncodedCommunication<SevenBitEncoding::getEncodedBufferSize(9), 16> comm(fake);
+
+    const std::array<uint8_t, 9> message = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    ASSERT_TRUE(comm.writeMessage(message));
+    EXPECT_EQ(fake.written(), encodeFrames({std::vector<uint8_t>(message.begin(), message.end())}));
+}
+
+struct SevenBitEncodedCommunicationLayout {
+    Communication* inner;
+    uint8_t txBuffer[16];
+    size_t txIndex;
+    bool corked;
+    uint8_t rxBuffer[16];
+    SevenBitFrameScanner rx;
+    bool resync;
+};
+
+static_assert(sizeof(SevenBitEncodedCommunication<16, 16>) == sizeof(SevenBitEncodedCommunicationLayout),
+              "NoStats adds nothing to the object");
+
+TEST(SevenBitEncodedCommunicationTests, CounterStatsTrackFramesAndBuffer) {
+    FakeCommunication fake;
+    SevenBitEncodedCommunication<8, 8, LocalCounterStats> comm(fake);
+
+    const std::vector<uint8_t> payload = {0x01, 0x02, 0x03};
+    ASSERT_TRUE(comm.writeMessage(payload.data(), payload.size()));
+    const std::vector<uint8_t> tooLarge(8, 0xAA);
+    EXPECT_FALSE(comm.writeMessage(tooLarge.data(), tooLarge.size()));
+
+    EXPECT_EQ(comm.stats().framesSent(), 1u);
+    EXPECT_EQ(comm.stats().bytesSent(), 3u);
+    EXPECT_EQ(comm.stats().framesRejected(), 1u);
+    EXPECT_EQ(comm.stats().bytesWritten(), 4u);
+
+    // Two frames in one read: the second is moved to the front after the first is taken. The single 0x00
+    // byte decodes to nothing and is dropped.
+    std::vector<uint8_t> incoming = encodeFrames({payload});
+    incoming.push_back(0x00);
+    fake.pushIncoming(incoming);
+
+    std::vector<uint8_t> out(8);
+    size_t outLen = 0;
+    EXPECT_TRUE(comm.readMessage(out.data(), out.size(), outLen));
+    EXPECT_FALSE(comm.readMessage(out.data(), out.size(), outLen));
+
+    EXPECT_EQ(comm.stats().framesReceived(), 1u);
+    EXPECT_EQ(comm.stats().bytesReceived(), 3u);
+    EXPECT_EQ(comm.stats().framesDropped(), 1u);
+    EXPECT_EQ(comm.stats().rxHighWater(), 5u);
+    EXPECT_EQ(comm.stats().bytesCompacted(), 1u);
+    EXPECT_EQ(comm.stats().bytesScanned(), 5u);
+    EXPECT_EQ(comm.stats().longestScan(), 4u);
+
+    // Eight bytes without a terminator fill the rx buffer
+    fake.pushIncoming(std::vector<uint8_t>(8, 0x80));
+    EXPECT_FALSE(comm.readMessage(out.data(), out.size(), outLen));
+    EXPECT_EQ(comm.stats().rxOverflows(), 1u);
+}
+
+TEST(SevenBitEncodedCommunicationTests, AtomicCounterStatsAreReadable) {
+    FakeCommunication fake;
+    SevenBitEncodedCommunication<16, 16, CounterStats> comm(fake);
+
+    const std::vector<uint8_t> payload = {0x42};
+    ASSERT_TRUE(comm.writeMessage(payload.data(), payload.size()));
+    ASSERT_TRUE(comm.writeMessage(payload.data(), payload.size()));
+    EXPECT_EQ(comm.stats().framesSent(), 2u);
+}
+
+TEST(SevenBitEncodedCommunicationTests, OverflowStallsWithoutResync) {
+    FakeCommunication fake;
+    SevenBitEncodedCommunication<8, 8, LocalCounterStats> comm(fake);
+
+    fake.pushIncoming(std::vector<uint8_t>(12, 0x80));
+    fake.pushIncoming({0x00});
+    fake.pushIncoming(encodeFrames({{0x01, 0x02}}));
+
+    std::vector<uint8_t> out(8);
+    size_t outLen = 0;
+    for (int i = 0; i < 4; i++) {
+        EXPECT_FALSE(comm.readMessage(out.data(), out.size(), outLen));
+    }
+    EXPECT_EQ(comm.discardedBytes(), 0u);
+    EXPECT_EQ(comm.stats().rxOverflows(), 1u); // one overflow, however often it is polled
+}
+
+TEST(SevenBitEncodedCommunicationTests, ResyncDropsOversizedFrameAndResumes) {
+    FakeCommunication fake;
+    SevenBitEncodedCommunication<8, 8, LocalCounterStats> comm(fake);
+    comm.setResyncOnOverflow(true);
+
+    // 13 bytes of one oversized frame, followed by a good one
+    fake.pushIncoming(std::vector<uint8_t>(12, 0x80));
+    fake.pushIncoming({0x00});
+    const std::vector<uint8_t> payload = {0x01, 0x02};
+    fake.pushIncoming(encodeFrames({payload}));
+
+    std::vector<uint8_t> out(8);
+    size_t outLen = 0;
+    EXPECT_FALSE(comm.readMessage(out.data(), out.size(), outLen)); // overflow, buffer dropped
+    EXPECT_EQ(comm.discardedBytes(), 8u);
+
+    ASSERT_TRUE(comm.readMessage(out.data(), out.size(), outLen));
+    EXPECT_EQ(std::vector<uint8_t>(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(outLen)), payload);
+    EXPECT_EQ(comm.discardedBytes(), 13u);
+    EXPECT_EQ(comm.stats().bytesDiscarded(), 13u);
+    EXPECT_EQ(comm.stats().rxOverflows(), 1u);
+    EXPECT_EQ(comm.pendingBytes(), 0u);
+}
+
+TEST(SevenBitEncodedCommunicationTests, ResyncWaitsForTerminatorAcrossReads) {
+    FakeCommunication fake;
+    SevenBitEncodedCommunication<8, 8> comm(fake);
+    comm.setResyncOnOverflow(true);
+
+    std::vector<uint8_t> out(8);
+    size_t outLen = 0;
+    fake.pushIncoming(std::vector<uint8_t>(8, 0x80));
+    EXPECT_FALSE(comm.readMessage(out.data(), out.size(), outLen));
+
+    // The rest of the oversized frame trickles in; none of it may be taken for a new frame
+    fake.pushIncoming({0x80, 0x80});
+    EXPECT_FALSE(comm.readMessage(out.data(), out.size(), outLen));
+    fake.pushIncoming({0x7F});
+    EXPECT_FALSE(comm.readMessage(out.data(), out.size(), outLen));
+    EXPECT_EQ(comm.discardedBytes(), 11u);
+
+    const std::vector<std::vector<uint8_t>> messages = {{0x05}, {0x06, 0x07}};
+    fake.pushIncoming(encodeFrames(messages));
+    std::vector<std::vector<uint8_t>> received;
+    comm.readMessages(
+        [&](const SevenBitMessageView& view) { received.emplace_back(view.data, view.data + view.size); });
+    EXPECT_EQ(received, messages);
+}
+
+namespace {
+    // Not a Communication: no virtual functions, only the same three members
+    class MemoryTransport {
+      public:
+        void write(const uint8_t* data, size_t size) {
+            bytes.insert(bytes.end(), data, data + size);
+        }
+
+        size_t available() const {
+            return bytes.size() - position;
+        }
+
+        size_t read(uint8_t* data, size_t size) {
+            const size_t toRead = std::min(size, available());
+            std::memcpy(data, bytes.data() + position, toRead);
+            position += toRead;
+            return toRead;
+        }
+
+        std::vector<uint8_t> bytes;
+        size_t position = 0;
+    };
+} // namespace
+
+static_assert(std::is_same_v<SevenBitEncodedCommunication<8, 8>,
+                             BasicSevenBitEncodedCommunication<Communication, 8, 8, NoStats>>,
+              "the virtual Communication stays the default transport");
+
+TEST(SevenBitEncodedCommunicationTests, WorksOverConcreteTransportType) {
+    MemoryTransport transport;
+    BasicSevenBitEncodedCommunication<MemoryTransport, 64, 64> comm(transport);
+
+    const std::vector<uint8_t> first = {0x01, 0x80, 0xFF};
+    const std::vector<uint8_t> second = {0x7F, 0x00, 0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70};
+    ASSERT_TRUE(comm.writeMessage(first.data(), first.size()));
+    ASSERT_TRUE(comm.writeMessage(second.data(), second.size()));
+
+    std::vector<uint8_t> out(16);
+    size_t outLen = 0;
+    ASSERT_TRUE(comm.readMessage(out.data(), out.size(), outLen));
+    EXPECT_EQ(std::vector<uint8_t>(out.begin(), out.begin() + outLen), first);
+
+    SevenBitMessageView view;
+    ASSERT_TRUE(comm.readMessageView(view));
+    EXPECT_EQ(std::vector<uint8_t>(view.data, view.data + view.size), second);
+    EXPECT_FALSE(comm.readMessage(out.data(), out.size(), outLen));
+}
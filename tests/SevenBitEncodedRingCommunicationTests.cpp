@@ -0,0 +1,160 @@
+#include "IntegralCommunication/Communication.h"
+#include "IntegralCommunication/CommunicationStats.h"
+#include "IntegralCommunication/SevenBitEncodedRingCommunication.h"
+#include "IntegralCommunication/SevenBitEncoding.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+namespace {
+    class LoopbackCommunication : public Communication {
+      public:
+        const std::vector<uint8_t>& written() const {
+            return _written;
+        }
+
+        void pushIncoming(const std::vector<uint8_t>& data) {
+            _incoming.insert(_incoming.end(), data.begin(), data.end());
+        }
+
+      private:
+        void writeImpl(const uint8_t* data, size_t size) override {
+            _written.insert(_written.end(), data, data + size);
+        }
+
+        size_t availableImpl() override {
+            return _incoming.size();
+        }
+
+        size_t readImpl(uint8_t* data, size_t size) override {
+            const size_t toRead = std::min(size, _incoming.size());
+            std::memcpy(data, _incoming.data(), toRead);
+            _incoming.erase(_incoming.begin(), _incoming.begin() + static_cast<std::ptrdiff_t>(toRead));
+            return toRead;
+        }
+
+        std::vector<uint8_t> _written;
+        std::vector<uint8_t> _incoming;
+    };
+
+    std::vector<uint8_t> encode(const std::vector<uint8_t>& payload) {
+        std::vector<uint8_t> encoded(SevenBitEncoding::getEncodedBufferSize(payload.size()));
+        encoded.resize(SevenBitEncoding::encodeBuffer(payload.data(), payload.size(), encoded.data()));
+        return encoded;
+    }
+} // namespace
+
+TEST(SevenBitEncodedRingCommunicationTests, WriteMessageEncodesAndForwards) {
+    LoopbackCommunication fake;
+    SevenBitEncodedRingCommunication<32, 32> comm(fake);
+
+    const std::vector<uint8_t> payload = {0x01, 0x02, 0xFF, 0x10};
+    ASSERT_TRUE(comm.writeMessage(payload.data(), payload.size()));
+    EXPECT_EQ(fake.written(), encode(payload));
+}
+
+TEST(SevenBitEncodedRingCommunicationTests, ReadMessageDecodesFrameWrappingAroundTheEnd) {
+    LoopbackCommunication fake;
+    SevenBitEncodedRingCommunication<32, 32, LocalCounterStats> comm(fake);
+
+    const std::vector<uint8_t> first(20, 0x55);
+    std::vector<uint8_t> second(20);
+    for (size_t i = 0; i < second.size(); ++i) {
+        second[i] = static_cast<uint8_t>(0xF0 - i);
+    }
+
+    uint8_t out[32] = {};
+    size_t outLen = 0;
+
+    // 23 encoded bytes, then 23 more that start at index 23 and wrap after 9 of them
+    fake.pushIncoming(encode(first));
+    ASSERT_TRUE(comm.readMessage(out, sizeof(out), outLen));
+    EXPECT_EQ(std::vector<uint8_t>(out, out + outLen), first);
+    EXPECT_EQ(comm.stats().bytesCompacted(), 0u);
+
+    fake.pushIncoming(encode(second));
+    ASSERT_TRUE(comm.readMessage(out, sizeof(out), outLen));
+    EXPECT_EQ(std::vector<uint8_t>(out, out + outLen), second);
+    EXPECT_EQ(comm.pendingBytes(), 0u);
+
+    // Only the group across the end was copied out
+    EXPECT_EQ(comm.stats().bytesCompacted(), 8u);
+    EXPECT_EQ(comm.stats().framesReceived(), 2u);
+}
+
+TEST(SevenBitEncodedRingCommunicationTests, ReadMessageDecodesFrameWrappingOnAGroupBoundaryInPlace) {
+    LoopbackCommunication fake;
+    SevenBitEncodedRingCommunication<32, 32, LocalCounterStats> comm(fake);
+
+    const std::vector<uint8_t> first(14, 0x55);
+    std::vector<uint8_t> second(20);
+    for (size_t i = 0; i < second.size(); ++i) {
+        second[i] = static_cast<uint8_t>(0x0F + i);
+    }
+
+    uint8_t out[32] = {};
+    size_t outLen = 0;
+
+    // 16 encoded bytes, then 23 more that wrap after two whole groups
+    fake.pushIncoming(encode(first));
+    ASSERT_TRUE(comm.readMessage(out, sizeof(out), outLen));
+    EXPECT_EQ(std::vector<uint8_t>(out, out + outLen), first);
+
+    fake.pushIncoming(encode(second));
+    ASSERT_TRUE(comm.readMessage(out, sizeof(out), outLen));
+    EXPECT_EQ(std::vector<uint8_t>(out, out + outLen), second);
+    EXPECT_EQ(comm.pendingBytes(), 0u);
+    EXPECT_EQ(comm.stats().bytesCompacted(), 0u);
+}
+
+TEST(SevenBitEncodedRingCommunicationTests, ReadMessageKeepsQueuedFramesInOrder) {
+    LoopbackCommunication fake;
+    SevenBitEncodedRingCommunication<64, 64> comm(fake);
+
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<size_t> sizeDist(1, 30);
+    std::uniform_int_distribution<size_t> chunkDist(1, 40);
+    std::uniform_int_distribution<int> byteDist(0, 255);
+
+    std::vector<std::vector<uint8_t>> sent;
+    std::vector<uint8_t> stream;
+    for (int i = 0; i < 500; ++i) {
+        std::vector<uint8_t> payload(sizeDist(rng));
+        for (auto& byte : payload) {
+            byte = static_cast<uint8_t>(byteDist(rng));
+        }
+        const std::vector<uint8_t> encoded = encode(payload);
+        stream.insert(stream.end(), encoded.begin(), encoded.end());
+        sent.push_back(payload);
+    }
+
+    std::vector<std::vector<uint8_t>> received;
+    uint8_t out[64] = {};
+    size_t outLen = 0;
+    size_t offset = 0;
+    while (offset < stream.size()) {
+        const size_t chunk = std::min(chunkDist(rng), stream.size() - offset);
+        fake.pushIncoming(std::vector<uint8_t>(stream.begin() + static_cast<std::ptrdiff_t>(offset),
+                                               stream.begin() + static_cast<std::ptrdiff_t>(offset + chunk)));
+        offset += chunk;
+        while (comm.readMessage(out, sizeof(out), outLen)) {
+            received.emplace_back(out, out + outLen);
+        }
+    }
+
+    EXPECT_EQ(comm.pendingBytes(), 0u);
+    EXPECT_EQ(received, sent);
+}
+
+TEST(SevenBitEncodedRingCommunicationTests, ReadMessageReturnsFalseWhenNoData) {
+    LoopbackCommunication fake;
+    SevenBitEncodedRingCommunication<16, 16> comm(fake);
+
+    uint8_t out[16] = {};
+    size_t outLen = 0;
+    EXPECT_FALSE(comm.readMessage(out, sizeof(out), outLen));
+    EXPECT_EQ(outLen, 0u);
+}
@@ -0,0 +1,137 @@
+#include "IntegralCommunication/Communication.h"
+#include "IntegralCommunication/SevenBitEncodedSender.h"
+#include "IntegralCommunication/SevenBitEncoding.h"
+#include <atomic>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Records each write separately; only the draining thread writes
+    class RecordingCommunication : public Communication {
+      public:
+        const std::vector<std::vector<uint8_t>>& writes() const {
+            return _writes;
+        }
+
+      private:
+        void writeImpl(const uint8_t* data, size_t size) override {
+            _writes.emplace_back(data, data + size);
+        }
+
+        size_t availableImpl() override {
+            return 0;
+        }
+
+        size_t readImpl(uint8_t*, size_t) override {
+            return 0;
+        }
+
+        std::vector<std::vector<uint8_t>> _writes;
+    };
+
+    // Splits a write into frames and decodes each one
+    std::vector<std::vector<uint8_t>> decodeFrames(const std::vector<uint8_t>& bytes) {
+        std::vector<std::vector<uint8_t>> frames;
+        size_t start = 0;
+        while (start < bytes.size()) {
+            const size_t end = start + SevenBitEncoding::findLastByte(bytes.data() + start, bytes.size() - start) + 1;
+            std::vector<uint8_t> frame(end - start);
+            frame.resize(SevenBitEncoding::decodeBuffer(bytes.data() + start, end - start, frame.data(), frame.size()));
+            frames.push_back(frame);
+            start = end;
+        }
+        return frames;
+    }
+} // namespace
+
+TEST(SevenBitEncodedSenderTests, DrainCoalescesFramesIntoWholeFrameWrites) {
+    RecordingCommunication inner;
+    SevenBitEncodedSender<8, 8, 10> sender(inner);
+
+    // 3 bytes encode to 4, so two frames share each write
+    const std::vector<std::vector<uint8_t>> messages = {{1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
+    for (const auto& msg : messages) {
+        ASSERT_TRUE(sender.submit(msg.data(), msg.size()));
+    }
+    EXPECT_EQ(inner.writes().size(), 0u);
+
+    EXPECT_EQ(sender.drain(), 3u);
+    ASSERT_EQ(inner.writes().size(), 2u);
+    EXPECT_EQ(decodeFrames(inner.writes()[0]), (std::vector<std::vector<uint8_t>>{messages[0], messages[1]}));
+    EXPECT_EQ(decodeFrames(inner.writes()[1]), (std::vector<std::vector<uint8_t>>{messages[2]}));
+    EXPECT_EQ(sender.drain(), 0u);
+}
+
+TEST(SevenBitEncodedSenderTests, SubmitRejectsOversizedFramesAndFullQueue) {
+    RecordingCommunication inner;
+    SevenBitEncodedSender<2, 8, 16> sender(inner);
+
+    const std::vector<uint8_t> tooLarge(8, 0xAA);
+    EXPECT_FALSE(sender.submit(tooLarge.data(), tooLarge.size()));
+
+    const uint8_t payload[] = {0x11};
+    EXPECT_TRUE(sender.submit(payload, sizeof(payload)));
+    EXPECT_TRUE(sender.submit(payload, sizeof(payload)));
+    EXPECT_FALSE(sender.submit(payload, sizeof(payload)));
+
+    EXPECT_EQ(sender.drain(), 2u);
+    EXPECT_TRUE(sender.submit(payload, sizeof(payload)));
+}
+
+TEST(SevenBitEncodedSenderTests, ConcurrentProducersNeverInterleaveFrames) {
+    constexpr size_t producers = 4;
+    constexpr size_t perProducer = 2000;
+
+    RecordingCommunication inner;
+    SevenBitEncodedSender<64, 16, 256> sender(inner);
+
+    std::atomic<size_t> running{producers};
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; p++) {
+        threads.emplace_back([&, p] {
+            for (size_t i = 0; i < perProducer;) {
+                const uint8_t payload[] = {static_cast<uint8_t>(p), static_cast<uint8_t>(i),
+                                           static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(p * 3)};
+                if (sender.submit(payload, sizeof(payload))) {
+                    i++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            running--;
+        });
+    }
+
+    size_t drained = 0;
+    while (running > 0 || drained < producers * perProducer) {
+        const size_t frames = sender.drain();
+        drained += frames;
+        if (frames == 0) {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Every write holds whole frames, and each producer's frames arrive complete and in order
+    std::vector<size_t> next(producers, 0);
+    bool valid = true;
+    for (const auto& write : inner.writes()) {
+        valid = valid && SevenBitEncoding::isLastByte(write.back());
+        for (const auto& frame : decodeFrames(write)) {
+            valid = valid && frame.size() == 4 && frame[0] < producers &&
+                    frame[3] == static_cast<uint8_t>(frame[0] * 3);
+            if (!valid) {
+                break;
+            }
+            const size_t index = frame[1] | (static_cast<size_t>(frame[2]) << 8);
+            valid = index == next[frame[0]]++;
+        }
+    }
+    EXPECT_TRUE(valid);
+    EXPECT_EQ(drained, producers * perProducer);
+    EXPECT_EQ(next, std::vector<size_t>(producers, perProducer));
+}
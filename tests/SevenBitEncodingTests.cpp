@@ -1,4 +1,5 @@
 #include "IntegralCommunication/SevenBitEncoding.h"
+#include <algorithm>
 #include <gtest/gtest.h>
 #include <random>
 #include <vector>
@@ -73,6 +74,26 @@ TEST(SevenBitEncoding, DecodeValueInvalidInput) {
     EXPECT_EQ(consumedBytes, 5);
 }
 
+TEST(SevenBitEncoding, DecodeValueWithReadAheadMatchesShortInput) {
+    // Inputs of 8 bytes and more take the word path; 5 bytes are all the byte loop can look at
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> byteDist(0, 255);
+    std::uniform_int_distribution<int> lengthDist(0, 5);
+    for (int i = 0; i < 10000; i++) {
+        uint8_t input[12];
+        for (auto& byte : input) {
+            byte = static_cast<uint8_t>(byteDist(rng) | 0x80);
+        }
+        input[lengthDist(rng)] &= 0x7F;
+
+        size_t expectedConsumed = 0;
+        size_t consumed = 0;
+        const uint32_t expected = SevenBitEncoding::decodeValue(input, 5, expectedConsumed);
+        EXPECT_EQ(SevenBitEncoding::decodeValue(input, sizeof(input), consumed), expected);
+        EXPECT_EQ(consumed, expectedConsumed);
+    }
+}
+
 class GetEncodedBufferSizeTest : public ::testing::TestWithParam<EncodedSizeTestCase> {};
 
 TEST_P(GetEncodedBufferSizeTest, ComputesCorrectSize) {
@@ -162,4 +183,412 @@ TEST(SevenBitEncoding, FuzzEncodeDecode) {
 TEST(SevenBitEncoding, IsLastByteTest) {
     EXPECT_EQ(SevenBitEncoding::isLastByte(0x7F), true);
     EXPECT_EQ(SevenBitEncoding::isLastByte(0x80), false);
-}
\ No newline at end of file
+}
+namespace {
+    // Bit-by-bit reference: the input as one big-endian bit stream, cut into zero-padded septets.
+    std::vector<uint8_t> referenceEncode(const std::vector<uint8_t>& input) {
+        std::vector<uint8_t> encoded((input.size() * 8 + 6) / 7, 0);
+        for (size_t bit = 0; bit < input.size() * 8; bit++) {
+            if ((input[bit / 8] >> (7 - (bit % 8))) & 1) {
+                encoded[bit / 7] |= static_cast<uint8_t>(1 << (6 - (bit % 7)));
+            }
+        }
+        for (size_t i = 0; i + 1 < encoded.size(); i++) {
+            encoded[i] |= 0x80;
+        }
+        return encoded;
+    }
+
+    std::vector<uint8_t> randomBytes(std::mt19937& rng, size_t length) {
+        std::uniform_int_distribution<int> byteDist(0, 255);
+        std::vector<uint8_t> bytes(length);
+        for (auto& byte : bytes) {
+            byte = static_cast<uint8_t>(byteDist(rng));
+        }
+        return bytes;
+    }
+} // namespace
+
+class KernelTest : public ::testing::TestWithParam<SevenBitEncoding::Kernel> {
+  protected:
+    void SetUp() override {
+        _previous = SevenBitEncoding::activeKernel();
+        if (!SevenBitEncoding::selectKernel(GetParam())) {
+            GTEST_SKIP() << "kernel not supported on this CPU";
+        }
+    }
+
+    void TearDown() override {
+        SevenBitEncoding::selectKernel(_previous);
+    }
+
+  private:
+    SevenBitEncoding::Kernel _previous = SevenBitEncoding::Kernel::Scalar;
+};
+
+TEST_P(KernelTest, EncodeBufferMatchesReference) {
+    std::mt19937 rng(1234);
+    for (size_t len = 1; len <= 300; len++) {
+        const std::vector<uint8_t> input = randomBytes(rng, len);
+        const std::vector<uint8_t> expected = referenceEncode(input);
+
+        std::vector<uint8_t> encoded(SevenBitEncoding::getEncodedBufferSize(len));
+        const size_t encodedLen = SevenBitEncoding::encodeBuffer(input.data(), input.size(), encoded.data());
+        ASSERT_EQ(encodedLen, expected.size()) << "length " << len;
+        encoded.resize(encodedLen);
+        ASSERT_EQ(encoded, expected) << "length " << len;
+    }
+}
+
+TEST_P(KernelTest, EncodeDecodeRoundTrip) {
+    std::mt19937 rng(42);
+    for (size_t len : {55u, 56u, 57u, 58u, 112u, 113u, 1000u, 4096u}) {
+        const std::vector<uint8_t> input = randomBytes(rng, len);
+        std::vector<uint8_t> encoded(SevenBitEncoding::getEncodedBufferSize(len));
+        const size_t encodedLen = SevenBitEncoding::encodeBuffer(input.data(), input.size(), encoded.data());
+
+        std::vector<uint8_t> decoded(len);
+        EXPECT_EQ(SevenBitEncoding::decodeBuffer(encoded.data(), encodedLen, decoded.data(), decoded.size()), len);
+        EXPECT_EQ(decoded, input) << "length " << len;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(SevenBitEncoding, KernelTest,
+                         ::testing::Values(SevenBitEncoding::Kernel::Scalar, SevenBitEncoding::Kernel::Ssse3,
+                                           SevenBitEncoding::Kernel::Avx2));
+
+TEST_P(KernelTest, DecodeBufferWithStatusRoundTrip) {
+    std::mt19937 rng(7);
+    for (size_t len = 1; len <= 300; len++) {
+        const std::vector<uint8_t> input = randomBytes(rng, len);
+        const std::vector<uint8_t> encoded = referenceEncode(input);
+
+        std::vector<uint8_t> decoded(len);
+        size_t decodedLen = 0;
+        ASSERT_EQ(SevenBitEncoding::decodeBuffer(encoded.data(), encoded.size(), decoded.data(), decoded.size(),
+                                                 decodedLen),
+                  SevenBitEncoding::DecodeStatus::Ok)
+            << "length " << len;
+        EXPECT_EQ(decodedLen, len);
+        ASSERT_EQ(decoded, input) << "length " << len;
+    }
+}
+
+TEST_P(KernelTest, DecodeBufferDetectsMissingContinuationBit) {
+    std::mt19937 rng(9);
+    const std::vector<uint8_t> input = randomBytes(rng, 200);
+    const std::vector<uint8_t> encoded = referenceEncode(input);
+
+    // Inside a SIMD block, in the scalar tail, and on the byte right before the terminator
+    for (size_t position : std::vector<size_t>{0, 63, 100, 200, encoded.size() - 2}) {
+        std::vector<uint8_t> corrupted = encoded;
+        corrupted[position] &= 0x7F;
+
+        std::vector<uint8_t> decoded(input.size());
+        size_t decodedLen = 123;
+        EXPECT_EQ(SevenBitEncoding::decodeBuffer(corrupted.data(), corrupted.size(), decoded.data(), decoded.size(),
+                                                 decodedLen),
+                  SevenBitEncoding::DecodeStatus::MissingContinuationBit)
+            << "position " << position;
+        EXPECT_EQ(decodedLen, 0u);
+    }
+}
+
+TEST(SevenBitEncoding, DecodeBufferWithStatusRejectsMalformedInput) {
+    using SevenBitEncoding::DecodeStatus;
+    const std::vector<uint8_t> encoded = {0x80, 0x80, 0xA0, 0xA0, 0x98, 0x90, 0x8A, 0x86, 0x83, 0xC2, 0x81, 0x10};
+    uint8_t out[16] = {};
+    size_t outLen = 0;
+
+    EXPECT_EQ(SevenBitEncoding::decodeBuffer(encoded.data(), encoded.size(), out, sizeof(out), outLen),
+              DecodeStatus::Ok);
+    EXPECT_EQ(outLen, 10u);
+
+    EXPECT_EQ(SevenBitEncoding::decodeBuffer(encoded.data(), encoded.size(), out, 9, outLen),
+              DecodeStatus::OutputTooSmall);
+    EXPECT_EQ(SevenBitEncoding::decodeBuffer(encoded.data(), encoded.size() - 1, out, sizeof(out), outLen),
+              DecodeStatus::MissingTerminator);
+    EXPECT_EQ(SevenBitEncoding::decodeBuffer(encoded.data(), 1, out, sizeof(out), outLen),
+              DecodeStatus::InvalidLength);
+    EXPECT_EQ(SevenBitEncoding::decodeBuffer(nullptr, encoded.size(), out, sizeof(out), outLen),
+              DecodeStatus::InvalidArgument);
+
+    const std::vector<uint8_t> paddingOnly = {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00};
+    EXPECT_EQ(SevenBitEncoding::decodeBuffer(paddingOnly.data(), paddingOnly.size(), out, sizeof(out), outLen),
+              DecodeStatus::InvalidLength);
+
+    EXPECT_EQ(SevenBitEncoding::decodeBuffer(encoded.data(), 0, out, sizeof(out), outLen), DecodeStatus::Ok);
+    EXPECT_EQ(outLen, 0u);
+}
+
+TEST_P(KernelTest, FindLastByteReturnsFirstTerminator) {
+    for (size_t length : {0u, 1u, 15u, 16u, 17u, 31u, 32u, 33u, 100u}) {
+        std::vector<uint8_t> buffer(length, 0x80);
+        EXPECT_EQ(SevenBitEncoding::findLastByte(buffer.data(), buffer.size()), length);
+
+        for (size_t position = 0; position < length; position++) {
+            buffer[position] = 0x7F;
+            if (position + 1 < length) {
+                buffer[position + 1] = 0x00; // only the first terminator counts
+            }
+            EXPECT_EQ(SevenBitEncoding::findLastByte(buffer.data(), buffer.size()), position)
+                << "length " << length << " position " << position;
+            std::fill(buffer.begin(), buffer.end(), 0x80);
+        }
+    }
+}
+
+TEST_P(KernelTest, DecodeBufferInPlace) {
+    std::mt19937 rng(5);
+    for (size_t len : {1u, 6u, 7u, 8u, 56u, 57u, 200u, 1000u}) {
+        const std::vector<uint8_t> input = randomBytes(rng, len);
+        std::vector<uint8_t> buffer = referenceEncode(input);
+
+        const size_t decodedLen = SevenBitEncoding::decodeBuffer(buffer.data(), buffer.size(), buffer.data(), buffer.size());
+        ASSERT_EQ(decodedLen, len);
+        EXPECT_EQ(std::vector<uint8_t>(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(len)), input)
+            << "length " << len;
+    }
+}
+
+TEST(SevenBitEncoding, EncodeBufferInPlaceMatchesEncodeBuffer) {
+    std::mt19937 rng(8);
+    for (size_t len = 0; len <= 300; len++) {
+        const std::vector<uint8_t> input = randomBytes(rng, len);
+        std::vector<uint8_t> expected(SevenBitEncoding::getEncodedBufferSize(len));
+        expected.resize(SevenBitEncoding::encodeBuffer(input.data(), input.size(), expected.data()));
+
+        std::vector<uint8_t> buffer(SevenBitEncoding::getEncodedBufferSize(len), 0xEE);
+        std::copy(input.begin(), input.end(), buffer.begin());
+        const size_t encodedLen = SevenBitEncoding::encodeBufferInPlace(buffer.data(), len);
+
+        ASSERT_EQ(encodedLen, expected.size()) << "length " << len;
+        buffer.resize(encodedLen);
+        EXPECT_EQ(buffer, expected) << "length " << len;
+    }
+}
+
+namespace {
+    constexpr std::array<uint8_t, 2> ENCODED_FF = SevenBitEncoding::encode(std::array<uint8_t, 1>{0xFF});
+    static_assert(ENCODED_FF[0] == 0xFF && ENCODED_FF[1] == 0x40, "encode<N> is usable at compile time");
+    static_assert(SevenBitEncoding::decode<1>(ENCODED_FF)[0] == 0xFF, "decode<N> is usable at compile time");
+    static_assert(SevenBitEncoding::getEncodedBufferSize(7) == 8, "getEncodedBufferSize is constexpr");
+
+#if INTEGRALCOMM_CONSTEXPR_CODEC
+    constexpr bool roundTripsAtCompileTime() {
+        const uint8_t input[9] = {0x00, 0xFF, 0x80, 0x7F, 0x55, 0xAA, 0x01, 0xFE, 0x42};
+        uint8_t encoded[SevenBitEncoding::getEncodedBufferSize(9)] = {};
+        uint8_t decoded[9] = {};
+        const size_t encodedLen = SevenBitEncoding::encodeBuffer(input, 9, encoded);
+        if (encodedLen != sizeof(encoded) || !SevenBitEncoding::isLastByte(encoded[encodedLen - 1])) {
+            return false;
+        }
+        if (SevenBitEncoding::decodeBuffer(encoded, encodedLen, decoded, 9) != 9) {
+            return false;
+        }
+        for (size_t i = 0; i < 9; i++) {
+            if (decoded[i] != input[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    static_assert(roundTripsAtCompileTime(), "encodeBuffer and decodeBuffer are usable at compile time");
+#endif
+
+    template <size_t N> void expectFixedSizeCodecMatches(std::mt19937& rng) {
+        std::array<uint8_t, N> input{};
+        const std::vector<uint8_t> bytes = randomBytes(rng, N);
+        std::copy(bytes.begin(), bytes.end(), input.begin());
+
+        const auto encoded = SevenBitEncoding::encode(input);
+        EXPECT_EQ(std::vector<uint8_t>(encoded.begin(), encoded.end()), referenceEncode(bytes)) << "N = " << N;
+        EXPECT_EQ(SevenBitEncoding::decode<N>(encoded), input) << "N = " << N;
+    }
+
+    template <size_t... N> void expectFixedSizeCodecMatches(std::mt19937& rng, std::index_sequence<N...> /*sizes*/) {
+        (expectFixedSizeCodecMatches<N + 1>(rng), ...);
+    }
+} // namespace
+
+TEST(SevenBitEncoding, FixedSizeCodecMatchesBufferCodec) {
+    std::mt19937 rng(21);
+    expectFixedSizeCodecMatches(rng, std::make_index_sequence<64>{});
+}
+
+namespace {
+    // Values of random bit length, biased towards the short ones the bulk decoder handles in vector lanes
+    template <typename T> std::vector<T> randomValues(std::mt19937& rng, size_t count, unsigned maxBits) {
+        std::uniform_int_distribution<unsigned> bitsDist(0, maxBits);
+        std::uniform_int_distribution<uint64_t> valueDist;
+        std::vector<T> values(count);
+        for (auto& value : values) {
+            const unsigned bits = std::min(bitsDist(rng), bitsDist(rng));
+            value = static_cast<T>(bits == 0 ? 0 : valueDist(rng) >> (64 - bits));
+        }
+        return values;
+    }
+} // namespace
+
+TEST_P(KernelTest, EncodeValuesMatchesEncodeValue) {
+    std::mt19937 rng(5);
+    const std::vector<uint32_t> values = randomValues<uint32_t>(rng, 1000, 32);
+
+    std::vector<uint8_t> expected;
+    for (uint32_t value : values) {
+        uint8_t bytes[SevenBitEncoding::MAX_ENCODED_VALUE_SIZE];
+        SevenBitEncoding::encodeValue(value, bytes);
+        expected.insert(expected.end(), bytes, bytes + SevenBitEncoding::getEncodedSize(value));
+    }
+
+    std::vector<uint8_t> encoded(values.size() * SevenBitEncoding::MAX_ENCODED_VALUE_SIZE);
+    encoded.resize(SevenBitEncoding::encodeValues(values.data(), values.size(), encoded.data()));
+    EXPECT_EQ(encoded, expected);
+}
+
+TEST_P(KernelTest, DecodeValuesRoundTrip) {
+    std::mt19937 rng(6);
+    for (unsigned maxBits : {7u, 14u, 21u, 32u}) {
+        const std::vector<uint32_t> values = randomValues<uint32_t>(rng, 2000, maxBits);
+        std::vector<uint8_t> encoded(values.size() * SevenBitEncoding::MAX_ENCODED_VALUE_SIZE);
+        encoded.resize(SevenBitEncoding::encodeValues(values.data(), values.size(), encoded.data()));
+
+        std::vector<uint32_t> decoded(values.size());
+        size_t consumed = 0;
+        EXPECT_EQ(SevenBitEncoding::decodeValues(encoded.data(), encoded.size(), decoded.data(), decoded.size(),
+                                                 consumed),
+                  values.size());
+        EXPECT_EQ(consumed, encoded.size());
+        EXPECT_EQ(decoded, values) << "max bits " << maxBits;
+    }
+}
+
+TEST_P(KernelTest, DecodeValuesMatchesDecodeValueOnArbitraryInput) {
+    // Random bytes include over-long values, which both decoders have to cut at the same place
+    std::mt19937 rng(7);
+    for (size_t length = 0; length < 200; length++) {
+        const std::vector<uint8_t> input = randomBytes(rng, length);
+
+        std::vector<uint32_t> expected;
+        size_t position = 0;
+        while (position < input.size()) {
+            size_t used = 0;
+            const uint32_t value =
+                SevenBitEncoding::decodeValue(input.data() + position, input.size() - position, used);
+            if (!SevenBitEncoding::isLastByte(input[position + used - 1]) &&
+                used < SevenBitEncoding::MAX_ENCODED_VALUE_SIZE) {
+                break; // truncated
+            }
+            expected.push_back(value);
+            position += used;
+        }
+
+        std::vector<uint32_t> decoded(input.size());
+        size_t consumed = 0;
+        decoded.resize(
+            SevenBitEncoding::decodeValues(input.data(), input.size(), decoded.data(), decoded.size(), consumed));
+        EXPECT_EQ(decoded, expected) << "length " << length;
+        EXPECT_EQ(consumed, position) << "length " << length;
+    }
+}
+
+TEST_P(KernelTest, DecodeValuesStopsAtTruncatedValueAndResumes) {
+    std::mt19937 rng(8);
+    const std::vector<uint32_t> values = randomValues<uint32_t>(rng, 300, 21);
+    std::vector<uint8_t> encoded(values.size() * SevenBitEncoding::MAX_ENCODED_VALUE_SIZE);
+    encoded.resize(SevenBitEncoding::encodeValues(values.data(), values.size(), encoded.data()));
+
+    // Feed the stream in odd-sized pieces, keeping unconsumed bytes for the next call
+    std::vector<uint32_t> decoded(values.size());
+    size_t total = 0;
+    size_t start = 0;
+    for (size_t end = 0; end < encoded.size();) {
+        end = std::min(end + 37, encoded.size());
+        size_t consumed = 0;
+        total += SevenBitEncoding::decodeValues(encoded.data() + start, end - start, decoded.data() + total,
+                                                decoded.size() - total, consumed);
+        start += consumed;
+    }
+    EXPECT_EQ(total, values.size());
+    EXPECT_EQ(start, encoded.size());
+    EXPECT_EQ(decoded, values);
+}
+
+TEST_P(KernelTest, DecodeValuesRespectsCount) {
+    const std::vector<uint32_t> values(64, 5);
+    std::vector<uint8_t> encoded(values.size());
+    SevenBitEncoding::encodeValues(values.data(), values.size(), encoded.data());
+
+    std::vector<uint32_t> decoded(20, 0xDEAD);
+    size_t consumed = 0;
+    EXPECT_EQ(SevenBitEncoding::decodeValues(encoded.data(), encoded.size(), decoded.data(), 17, consumed), 17u);
+    EXPECT_EQ(consumed, 17u);
+    EXPECT_EQ(decoded[16], 5u);
+    EXPECT_EQ(decoded[17], 0xDEADu);
+}
+
+TEST_P(KernelTest, Values64RoundTrip) {
+    std::mt19937 rng(9);
+    const std::vector<uint64_t> values = randomValues<uint64_t>(rng, 2000, 64);
+
+    std::vector<uint8_t> expected;
+    for (uint64_t value : values) {
+        uint8_t bytes[SevenBitEncoding::MAX_ENCODED_VALUE64_SIZE];
+        SevenBitEncoding::encodeValue64(value, bytes);
+        const size_t size = SevenBitEncoding::getEncodedSize64(value);
+        expected.insert(expected.end(), bytes, bytes + size);
+
+        size_t used = 0;
+        EXPECT_EQ(SevenBitEncoding::decodeValue64(bytes, size, used), value);
+        EXPECT_EQ(used, size);
+    }
+
+    std::vector<uint8_t> encoded(values.size() * SevenBitEncoding::MAX_ENCODED_VALUE64_SIZE);
+    encoded.resize(SevenBitEncoding::encodeValues(values.data(), values.size(), encoded.data()));
+    EXPECT_EQ(encoded, expected);
+
+    std::vector<uint64_t> decoded(values.size());
+    size_t consumed = 0;
+    EXPECT_EQ(SevenBitEncoding::decodeValues(encoded.data(), encoded.size(), decoded.data(), decoded.size(), consumed),
+              values.size());
+    EXPECT_EQ(decoded, values);
+}
+
+TEST_P(KernelTest, SignedValuesRoundTrip) {
+    std::mt19937 rng(10);
+    std::vector<int32_t> values32;
+    std::vector<int64_t> values64;
+    for (uint64_t value : randomValues<uint64_t>(rng, 1000, 64)) {
+        const bool negative = (value & 1U) != 0;
+        values32.push_back(static_cast<int32_t>(negative ? -static_cast<int64_t>(value >> 33) : (value >> 33)));
+        values64.push_back(negative ? -static_cast<int64_t>(value >> 1) : static_cast<int64_t>(value >> 1));
+    }
+    values32.push_back(INT32_MIN);
+    values32.push_back(INT32_MAX);
+    values64.push_back(INT64_MIN);
+    values64.push_back(INT64_MAX);
+
+    std::vector<uint8_t> encoded(values64.size() * SevenBitEncoding::MAX_ENCODED_VALUE64_SIZE);
+    size_t consumed = 0;
+
+    encoded.resize(SevenBitEncoding::encodeSignedValues(values32.data(), values32.size(), encoded.data()));
+    std::vector<int32_t> decoded32(values32.size());
+    EXPECT_EQ(SevenBitEncoding::decodeSignedValues(encoded.data(), encoded.size(), decoded32.data(), decoded32.size(),
+                                                   consumed),
+              values32.size());
+    EXPECT_EQ(decoded32, values32);
+
+    encoded.resize(values64.size() * SevenBitEncoding::MAX_ENCODED_VALUE64_SIZE);
+    encoded.resize(SevenBitEncoding::encodeSignedValues(values64.data(), values64.size(), encoded.data()));
+    std::vector<int64_t> decoded64(values64.size());
+    EXPECT_EQ(SevenBitEncoding::decodeSignedValues(encoded.data(), encoded.size(), decoded64.data(), decoded64.size(),
+                                                   consumed),
+              values64.size());
+    EXPECT_EQ(decoded64, values64);
+}
+
+static_assert(SevenBitEncoding::zigZagEncode(0) == 0 && SevenBitEncoding::zigZagEncode(-1) == 1 &&
+                  SevenBitEncoding::zigZagEncode(1) == 2 && SevenBitEncoding::zigZagEncode(INT32_MIN) == UINT32_MAX,
+              "zig-zag puts small magnitudes first");
+static_assert(SevenBitEncoding::zigZagDecode64(SevenBitEncoding::zigZagEncode64(INT64_MIN)) == INT64_MIN,
+              "zig-zag round trips");
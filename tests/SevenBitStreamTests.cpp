@@ -0,0 +1,166 @@
+#include "IntegralCommunication/SevenBitEncoding.h"
+#include "IntegralCommunication/SevenBitStream.h"
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+    std::vector<uint8_t> randomPayload(std::mt19937& rng, size_t length) {
+        std::uniform_int_distribution<int> byteDist(0, 255);
+        std::vector<uint8_t> payload(length);
+        for (auto& byte : payload) {
+            byte = static_cast<uint8_t>(byteDist(rng));
+        }
+        return payload;
+    }
+
+    std::vector<uint8_t> encodeWhole(const std::vector<uint8_t>& payload) {
+        std::vector<uint8_t> encoded(SevenBitEncoding::getEncodedBufferSize(payload.size()));
+        encoded.resize(SevenBitEncoding::encodeBuffer(payload.data(), payload.size(), encoded.data()));
+        return encoded;
+    }
+} // namespace
+
+TEST(SevenBitStreamTests, EncoderMatchesEncodeBufferForAnyChunking) {
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<size_t> chunkDist(0, 20);
+    SevenBitEncoder encoder;
+
+    for (size_t len = 0; len < 200; len++) {
+        const std::vector<uint8_t> payload = randomPayload(rng, len);
+
+        std::vector<uint8_t> encoded;
+        size_t offset = 0;
+        while (offset < payload.size()) {
+            const size_t chunk = std::min(chunkDist(rng), payload.size() - offset);
+            std::vector<uint8_t> out(SevenBitEncoder::getEncodedChunkSize(chunk));
+            const size_t written = encoder.encode(payload.data() + offset, chunk, out.data());
+            ASSERT_LE(written, out.size());
+            encoded.insert(encoded.end(), out.begin(), out.begin() + static_cast<std::ptrdiff_t>(written));
+            offset += chunk;
+        }
+        uint8_t tail[SevenBitEncoder::MAX_FINISH_SIZE] = {};
+        const size_t written = encoder.finish(tail);
+        encoded.insert(encoded.end(), tail, tail + written);
+
+        EXPECT_EQ(encoded, encodeWhole(payload)) << "length " << len;
+    }
+}
+
+TEST(SevenBitStreamTests, EncoderStaysWithinChunkSizeAfterHeldBackSeptet) {
+    constexpr uint8_t GUARD = 0xCC;
+    std::mt19937 rng(5);
+    const std::vector<uint8_t> payload = randomPayload(rng, 1 + 7 + 14 + 21);
+    SevenBitEncoder encoder;
+
+    // The first byte leaves a septet held back, so each group-aligned chunk after it starts with that byte
+    size_t offset = 0;
+    std::vector<uint8_t> encoded;
+    for (const size_t chunk : {size_t{1}, size_t{7}, size_t{14}, size_t{21}}) {
+        const size_t chunkSize = SevenBitEncoder::getEncodedChunkSize(chunk);
+
+        // Guard bytes behind the chunk size catch the overrun in plain builds
+        SevenBitEncoder guarded = encoder;
+        std::vector<uint8_t> out(chunkSize + 8, GUARD);
+        const size_t guardedWritten = guarded.encode(payload.data() + offset, chunk, out.data());
+        EXPECT_TRUE(std::all_of(out.begin() + static_cast<std::ptrdiff_t>(chunkSize), out.end(),
+                                [](uint8_t byte) { return byte == GUARD; }))
+            << "chunk " << chunk;
+
+        // An exactly sized heap buffer lets the sanitizers catch it
+        const auto exact = std::make_unique<uint8_t[]>(chunkSize);
+        const size_t written = encoder.encode(payload.data() + offset, chunk, exact.get());
+        ASSERT_EQ(written, guardedWritten);
+        EXPECT_LE(written, chunkSize);
+        EXPECT_TRUE(std::equal(exact.get(), exact.get() + written, out.begin()));
+
+        encoded.insert(encoded.end(), exact.get(), exact.get() + written);
+        offset += chunk;
+    }
+    uint8_t tail[SevenBitEncoder::MAX_FINISH_SIZE] = {};
+    const size_t written = encoder.finish(tail);
+    encoded.insert(encoded.end(), tail, tail + written);
+    EXPECT_EQ(encoded, encodeWhole(payload));
+}
+
+TEST(SevenBitStreamTests, DecoderHandlesSmallInputAndOutputChunks) {
+    std::mt19937 rng(12);
+    std::uniform_int_distribution<size_t> chunkDist(1, 70);
+    SevenBitDecoder decoder;
+
+    for (size_t len = 1; len < 300; len += 7) {
+        const std::vector<uint8_t> payload = randomPayload(rng, len);
+        const std::vector<uint8_t> encoded = encodeWhole(payload);
+
+        std::vector<uint8_t> decoded;
+        size_t offset = 0;
+        SevenBitDecoder::Status status = SevenBitDecoder::Status::NeedInput;
+        while (status != SevenBitDecoder::Status::FrameComplete) {
+            ASSERT_LT(offset, encoded.size());
+            const size_t inChunk = std::min(chunkDist(rng), encoded.size() - offset);
+            std::vector<uint8_t> out(chunkDist(rng));
+            size_t consumed = 0;
+            size_t produced = 0;
+            status = decoder.decode(encoded.data() + offset, inChunk, consumed, out.data(), out.size(), produced);
+            decoded.insert(decoded.end(), out.begin(), out.begin() + static_cast<std::ptrdiff_t>(produced));
+            offset += consumed;
+        }
+
+        EXPECT_EQ(offset, encoded.size());
+        EXPECT_EQ(decoded, payload) << "length " << len;
+    }
+}
+
+TEST(SevenBitStreamTests, DecoderStopsAtEachFrameEnd) {
+    const std::vector<uint8_t> first = {0x01, 0x02, 0x03};
+    const std::vector<uint8_t> second = {0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF, 0x11, 0x22};
+    std::vector<uint8_t> stream = encodeWhole(first);
+    const std::vector<uint8_t> encodedSecond = encodeWhole(second);
+    stream.insert(stream.end(), encodedSecond.begin(), encodedSecond.end());
+
+    SevenBitDecoder decoder;
+    uint8_t out[16] = {};
+    size_t consumed = 0;
+    size_t produced = 0;
+
+    ASSERT_EQ(decoder.decode(stream.data(), stream.size(), consumed, out, sizeof(out), produced),
+              SevenBitDecoder::Status::FrameComplete);
+    EXPECT_EQ(std::vector<uint8_t>(out, out + produced), first);
+
+    const size_t offset = consumed;
+    ASSERT_EQ(decoder.decode(stream.data() + offset, stream.size() - offset, consumed, out, sizeof(out), produced),
+              SevenBitDecoder::Status::FrameComplete);
+    EXPECT_EQ(std::vector<uint8_t>(out, out + produced), second);
+    EXPECT_EQ(offset + consumed, stream.size());
+}
+
+TEST(SevenBitStreamTests, DecoderReportsFullOutput) {
+    const std::vector<uint8_t> payload = {0x10, 0x20, 0x30, 0x40};
+    const std::vector<uint8_t> encoded = encodeWhole(payload);
+
+    SevenBitDecoder decoder;
+    uint8_t out[2] = {};
+    size_t consumed = 0;
+    size_t produced = 0;
+    ASSERT_EQ(decoder.decode(encoded.data(), encoded.size(), consumed, out, sizeof(out), produced),
+              SevenBitDecoder::Status::OutputFull);
+    EXPECT_EQ(produced, 2u);
+    EXPECT_EQ(out[0], 0x10);
+    EXPECT_EQ(out[1], 0x20);
+
+    size_t rest = 0;
+    ASSERT_EQ(decoder.decode(encoded.data() + consumed, encoded.size() - consumed, rest, out, sizeof(out), produced),
+              SevenBitDecoder::Status::FrameComplete);
+    EXPECT_EQ(produced, 2u);
+    EXPECT_EQ(out[0], 0x30);
+    EXPECT_EQ(out[1], 0x40);
+}
+
+TEST(SevenBitStreamTests, EncoderFinishWithoutInputWritesNothing) {
+    SevenBitEncoder encoder;
+    uint8_t out[SevenBitEncoder::MAX_FINISH_SIZE] = {};
+    EXPECT_EQ(encoder.finish(out), 0u);
+}
@@ -0,0 +1,143 @@
+#include "IntegralCommunication/SevenBitEncodedCommunication.h"
+#include "IntegralCommunication/SevenBitEncoding.h"
+#include "IntegralCommunication/SpscRingBuffer.h"
+#include "IntegralCommunication/SpscRingCommunication.h"
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+TEST(SpscRingBufferTests, WriteAndReadWrapAround) {
+    SpscRingBuffer<8> ring;
+    const uint8_t first[] = {1, 2, 3, 4, 5, 6};
+    EXPECT_EQ(ring.write(first, sizeof(first)), 6u);
+
+    uint8_t out[8] = {};
+    EXPECT_EQ(ring.read(out, 4), 4u);
+
+    // Only 6 of the next 7 bytes fit, split over the end of the array
+    const uint8_t second[] = {7, 8, 9, 10, 11, 12, 13};
+    EXPECT_EQ(ring.write(second, sizeof(second)), 6u);
+    EXPECT_EQ(ring.available(), 8u);
+    EXPECT_EQ(ring.freeSpace(), 0u);
+
+    EXPECT_EQ(ring.read(out, sizeof(out)), 8u);
+    const std::vector<uint8_t> expected = {5, 6, 7, 8, 9, 10, 11, 12};
+    EXPECT_EQ(std::vector<uint8_t>(out, out + 8), expected);
+    EXPECT_EQ(ring.available(), 0u);
+}
+
+TEST(SpscRingBufferTests, PrepareWriteExposesContiguousRegions) {
+    SpscRingBuffer<8> ring;
+    uint8_t scratch[8] = {};
+    ring.write(scratch, 5);
+    ring.read(scratch, 5);
+
+    // Position 5: three bytes up to the end of the array, then five from its start
+    size_t size = 0;
+    uint8_t* region = ring.prepareWrite(size);
+    ASSERT_EQ(size, 3u);
+    region[0] = 0xA0;
+    region[1] = 0xA1;
+    region[2] = 0xA2;
+    ring.commitWrite(3);
+
+    region = ring.prepareWrite(size);
+    ASSERT_EQ(size, 5u);
+    region[0] = 0xA3;
+    ring.commitWrite(1);
+
+    const uint8_t* readable = ring.prepareRead(size);
+    ASSERT_EQ(size, 3u);
+    EXPECT_EQ(readable[0], 0xA0);
+    ring.commitRead(3);
+    readable = ring.prepareRead(size);
+    ASSERT_EQ(size, 1u);
+    EXPECT_EQ(readable[0], 0xA3);
+}
+
+TEST(SpscRingBufferTests, ProducerAndConsumerThreadsSeeEveryByteInOrder) {
+    constexpr size_t total = 1 << 18;
+    SpscRingBuffer<256> ring;
+
+    std::thread producer([&] {
+        uint8_t chunk[37];
+        size_t sent = 0;
+        while (sent < total) {
+            const size_t size = std::min(sizeof(chunk), total - sent);
+            for (size_t i = 0; i < size; i++) {
+                chunk[i] = static_cast<uint8_t>((sent + i) * 7);
+            }
+            for (size_t written = 0; written < size; std::this_thread::yield()) {
+                written += ring.write(chunk + written, size - written);
+            }
+            sent += size;
+        }
+    });
+
+    size_t received = 0;
+    bool inOrder = true;
+    uint8_t chunk[53];
+    while (received < total) {
+        const size_t read = ring.read(chunk, sizeof(chunk));
+        for (size_t i = 0; i < read; i++) {
+            inOrder = inOrder && chunk[i] == static_cast<uint8_t>((received + i) * 7);
+        }
+        received += read;
+        if (read == 0) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(inOrder);
+    EXPECT_EQ(ring.available(), 0u);
+}
+
+TEST(SpscRingCommunicationTests, FeedsSevenBitEncodedCommunicationFromAnotherThread) {
+    SpscRingCommunication<1024, 1024> link;
+    SevenBitEncodedCommunication<64, 256> comm(link);
+
+    constexpr size_t frames = 2000;
+    std::thread isr([&] {
+        for (size_t i = 0; i < frames; i++) {
+            const uint8_t payload[] = {static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8), 0x55};
+            uint8_t encoded[SevenBitEncoding::getEncodedBufferSize(sizeof(payload))];
+            const size_t encodedLen = SevenBitEncoding::encodeBuffer(payload, sizeof(payload), encoded);
+            for (size_t written = 0; written < encodedLen; std::this_thread::yield()) {
+                written += link.rx().write(encoded + written, encodedLen - written);
+            }
+        }
+    });
+
+    size_t received = 0;
+    bool inOrder = true;
+    uint8_t out[16];
+    while (received < frames) {
+        size_t outLen = 0;
+        if (comm.readMessage(out, sizeof(out), outLen)) {
+            inOrder = inOrder && outLen == 3 && out[0] == static_cast<uint8_t>(received) &&
+                      out[1] == static_cast<uint8_t>(received >> 8) && out[2] == 0x55;
+            received++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    isr.join();
+    EXPECT_TRUE(inOrder);
+}
+
+TEST(SpscRingCommunicationTests, WritesGoToTxRingWholeOrNotAtAll) {
+    SpscRingCommunication<16, 8> link;
+    SevenBitEncodedCommunication<16, 16> comm(link);
+
+    const uint8_t payload[] = {1, 2, 3, 4, 5, 6};
+    ASSERT_TRUE(comm.writeMessage(payload, sizeof(payload)));
+    EXPECT_EQ(link.tx().available(), SevenBitEncoding::getEncodedBufferSize(sizeof(payload)));
+
+    // The second frame does not fit in the one byte left and is dropped rather than cut
+    ASSERT_TRUE(comm.writeMessage(payload, sizeof(payload)));
+    EXPECT_EQ(link.droppedTxBytes(), SevenBitEncoding::getEncodedBufferSize(sizeof(payload)));
+    EXPECT_EQ(link.tx().available(), SevenBitEncoding::getEncodedBufferSize(sizeof(payload)));
+}